@@ -1,2224 +1,3257 @@
-/*
- * File:   libbwt.c
- * Author: Matthias Petri
- *
- *  BWT implementation based on
- *  "An efficient method for in memory construction of suffix arrays"
- *  by Itoh, Hideo and Tanaka, H.
- */
-/* >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-   ds.c
-   deep-shallow sorting algorithm. these routines are taken mainly by
-   Seward's d_copyEQ_u12.c
-   Buckets are sorted one at a time; when  bucket Y is completely sorted
-   (except for YY) "pointer copying" is used to sort small buckets of
-   the form XY, X=A..Z
-   >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
-
-#include "libutil.h"
-#include "libbwt.h"
-/* *******************************************************************
-   globals.c
-   Ver 1.0   14-oct-02
-   This file contains the definition of the global variables
-   which can be defined by the user + some relate procedures
-   ******************************************************************* */
-#include <assert.h>
-#include <limits.h>
-
-/* ---- global variables (modifiable by command line options) ----- */
-int Anchor_dist;
-int Shallow_limit;
-int _ds_Verbose;
-int _ds_Word_size;
-int Mk_qs_thresh;
-int32_t Max_pseudo_anchor_offset;
-
-int32_t B2g_ratio;
-
-int32_t Update_anchor_ranks;
-
-int32_t Blind_sort_ratio;
-
-
-int32_t  Text_size;
-uint8_t*  Upper_text_limit;
-
-int check_global_variables(void);
-void set_global_variables(void);
-int compute_overshoot(void);
-
-
-uint8_t* Text;
-int32_t* Sa;
-int32_t ftab [65537];
-uint16_t*  Anchor_offset;
-int32_t*  Anchor_rank;
-
-int32_t Calls_helped_sort=0;
-int32_t Calls_anchor_sort_forw=0;
-int32_t Calls_anchor_sort_backw=0;
-int32_t Calls_pseudo_anchor_sort_forw=0;
-int32_t Calls_deep_sort=0;
-
-
-
-void deep_sort(int32_t* a, int32_t n, int32_t depth);
-
-
-
-
-#define Get_small_bucket(pos) ((Text[pos]<<8) + Text[pos+1])
-
-
-
-void general_anchor_sort(int32_t* a,int32_t n,int32_t pos,int32_t rank,int32_t off);
-
-void pseudo_anchor_sort(int32_t* a, int32_t n,int32_t pseudo_an,int32_t offset);
-int32_t split_group(int32_t* a, int n, int,int,int32_t,int*);
-void update_anchors(int32_t* a, int32_t n);
-void pseudo_or_deep_sort(int32_t* a, int32_t n, int32_t depth);
-
-
-
-
-
-
-
-
-
-
-/* ------- node of blind trie -------- */
-typedef struct nodex {
-    int32_t skip;
-    uint8_t key;
-    struct nodex*  down;
-    struct nodex* right;
-} node;
-
-
-
-#define BUFSIZE 1000
-#define FREESIZE 5000
-void* freearr[FREESIZE];
-static node* bufn;
-static int bufn_num=0, free_num=0;
-static int32_t* Aux, Aux_written;
-node** Stack;
-int Stack_size;
-
-
-int neg_integer_cmp(const void*, const void*);
-node* find_companion(node* head, uint8_t* s);
-void insert_suffix(node* h, int32_t suf, int n, uint8_t mmchar);
-void traverse_trie(node* h);
-int32_t compare_suffixes(int32_t suf1, int32_t suf2, int32_t depth);
-void free_node_mem();
-node* get_leaf(node* head);
-
-
-
-/* ****************************************************************
-   routine for deep-sorting the suffixes a[0] ... a[n-1]
-   knowing that they have a common prefix of length "depth"
-  **************************************************************** */
-void blind_ssort(int32_t* a, int32_t n, int32_t depth)
-{
-    int32_t i,j,aj,lcp;
-    node nh, *root, *h;
-
-
-    qsort(a,n, sizeof(int32_t), neg_integer_cmp);
-
-
-    for (j=0; j<n; j++)
-        if (a[j]+depth < Text_size)
-            break;
-    if (j>=n-1) return;
-
-
-    Stack = (node**) malloc(n*sizeof(node*));
-    if (Stack==NULL) {
-        fprintf(stderr,"Out of memory! (blind_ssort)\n");
-        exit(1);
-    }
-
-
-    nh.skip = -1;   nh.right = NULL; nh.down = (void*) a[j];
-    root = &nh;
-
-
-    for (i=j+1; i<n; i++) {
-        h=find_companion(root, Text+a[i]);
-        assert(h->skip==-1);
-        assert(Stack_size<=i-j);
-        aj=(int32_t) h->down;
-        assert(aj>a[i]);
-        lcp = compare_suffixes(aj,a[i],depth);
-        insert_suffix(root, a[i], lcp, Text[aj+lcp]);
-    }
-
-
-    Aux=a;  Aux_written = j;
-    traverse_trie(root);
-    assert(Aux_written==n);
-
-    free_node_mem();
-    free(Stack);
-}
-
-/* ***********************************************************************
-   this function traverses the trie rooted at head following the string s.
-   Returns the leaf "corresponding" to the string s
-   *********************************************************************** */
-node* find_companion(node* head, uint8_t* s)
-{
-    uint8_t c;
-    node* p;
-    int t;
-
-    Stack_size = 0;
-    while (head->skip >= 0) {
-        Stack[Stack_size++] = head;
-        t = head->skip;
-        if (s+t>=Upper_text_limit)
-            return get_leaf(head);
-        c = s[t]; p = head->down;
-repeat:
-        if (c==p->key) {
-            head = p;
-            continue;
-        } else if (c<p->key)
-            return get_leaf(head);
-        if ((p=(p->right))==NULL)
-            return get_leaf(head);
-        goto repeat;
-    }
-    Stack[Stack_size++] = head;
-    return head;
-}
-
-
-
-
-node* get_leaf(node* head)
-{
-    assert(head->skip>=0);
-
-    do {
-        head = head->down;
-    } while (head->skip>=0);
-    return head;
-}
-
-
-
-node* new_node__blind_ssort(void)
-{
-    if (bufn_num-- == 0) {
-        bufn = (node*) malloc(BUFSIZE * sizeof(node));
-        if (bufn==NULL) {
-            fprintf(stderr,"Out of mem (new_node1)\n"); exit(1);
-        }
-        freearr[free_num++] = (void*) bufn;
-        if (free_num>=FREESIZE) {
-            fprintf(stderr,"Out of mem (new_node2)\n"); exit(1);
-        }
-        bufn_num = BUFSIZE-1;
-    }
-    return bufn++;
-}
-
-
-/* *****************************************************
-   insert a suffix in the trie rooted at *p.
-   we know that the trie already contains a string
-   which share the first n chars with suf
-   ***************************************************** */
-void insert_suffix(node* h, int32_t suf, int n, uint8_t mmchar)
-{
-    node* new_node__blind_ssort(void);
-    int32_t t;
-    uint8_t c, *s;
-    node* p, **pp;
-
-    s = Text + suf;
-
-#if 0
-
-    while ((t=h->skip) < n) {
-        if (t < 0) break;
-        c=s[t];  p=h->down;
-
-repeat:
-        if (c==p->key) {
-            h = p;
-            continue;
-        }
-        if (c>p->key && p->right!=NULL) {
-            p=p->right;
-            goto repeat;
-        }
-
-        fprintf(stderr,"Error in blind_sort (insert_string)\n");
-        exit(1);
-    }
-#else
-    for (t=0; t<Stack_size; t++) {
-        h=Stack[t];
-        if (h->skip<0 || h->skip>=n) break;
-    }
-#endif
-
-    assert(s[n]!=mmchar || h->skip==-1 || h->skip==n);
-
-
-    if (h->skip!=n) {
-        p = new_node__blind_ssort();
-        p->key = mmchar;
-        p->skip = h->skip;
-        p->down = h->down;
-        p->right = NULL;
-        h->skip = n;
-        h->down = p;
-    }
-    assert(h->skip==n);
-
-
-    c=s[n]; pp = &(h->down);
-    while ((*pp)!=NULL) {
-        if ((*pp)->key>=c)
-            break;
-        pp = &((*pp)->right);
-    }
-
-    p = new_node__blind_ssort();
-    p->skip = -1;
-    p->key = c;
-    p->right = *pp; *pp = p;
-    p->down = (void*) suf;
-    return;
-}
-
-/* ************************************************************
-   this procedures traverse the trie in depth first order
-   so that the suffixes (stored in the leaf) are recovered
-   in lexicographic order
-   ************************************************************ */
-void traverse_trie(node* h)
-{
-    node* p, *nextp;
-
-    if (h->skip<0)
-        Aux[Aux_written++] = (int32_t) h->down;
-    else {
-        p = h->down;
-        assert(p!=NULL);
-        do {
-            nextp = p->right;
-            if (nextp!=NULL) {
-                assert(nextp->key>=p->key);
-
-
-                if (nextp->key==p->key) {
-                    traverse_trie(nextp);
-                    traverse_trie(p);
-                    p = nextp->right;
-                    continue;
-                }
-            }
-            traverse_trie(p);
-            p=nextp;
-        } while (p!=NULL);
-    }
-}
-
-
-
-/* ***********************************************************************
-   Function to compute the lcp of two strings originating from the *b1 and *b2
-   the parameter is the length of s1 (which is shortest than s2)
-   if s1 is a prefix of s2 we return the length of s1 -1
-   The size of the unrolled loop must be at most equal to the costant
-   Cmp_overshoot defined in common.h
-   the function return the result of the comparison (+ or -) and writes
-   in Cmp_done the number of comparisons done
-   *********************************************************************** */
-static
-int32_t get_lcp_unrolled(uint8_t* b1, uint8_t* b2, int32_t cmp_limit)
-{
-    int32_t cmp2do;
-    uint8_t c1, c2;
-    assert(b1 != b2);
-
-
-
-    cmp2do = cmp_limit;
-    do {
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  1; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  2; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  3; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  4; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  5; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  6; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  7; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  8; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -=  9; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 10; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 11; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 12; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 13; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 14; break;
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            cmp2do -= 15; break;
-        }
-        b1++; b2++;
-
-        cmp2do -= 16;
-    } while (cmp2do>0);
-
-
-    if (cmp_limit - cmp2do < cmp_limit)
-        return cmp_limit-cmp2do;
-
-    return cmp_limit-1;
-}
-
-
-
-/* ************************************************************************
-   this function returns the lcp between suf1 and suf2 (that is returns n
-   such that suf1[n]!=suf2[n] but suf1[i]==suf2[i] for i=0..n-1
-   However, it is possible that suf1 is a prefix of suf2 (not vice-versa
-   because of the initial sorting of suffixes in order of descreasing length)
-   in this case the function returns n=length(suf1)-1. So in this case
-   suf1[n]==suf2[n] (and suf1[n+1] does not exists).
-   ************************************************************************ */
-int32_t compare_suffixes(int32_t suf1, int32_t suf2, int32_t depth)
-{
-    int32_t get_lcp_unrolled(uint8_t*, uint8_t*, int32_t);
-    int limit;
-    uint8_t* s1, *s2;
-
-    assert(suf1>suf2);
-    s1  = Text + depth +suf1;
-    s2  = Text + depth +suf2;
-    limit = Text_size - suf1 - depth;
-    return depth + get_lcp_unrolled(s1 ,s2, limit);
-}
-
-
-
-/* ******************************************************************
-   comparison function used to sort suffixes in order of
-   increasing length. Since suffixes are represented by their offset
-   in the array, we sort these offsets in order of decreasing length.
-   ****************************************************************** */
-int neg_integer_cmp(const void* a, const void* b)
-{
-    return *((int32_t*) b) -  *((int32_t*) a);
-}
-
-
-
-void free_node_mem()
-{
-    int i;
-
-    for (i=free_num-1; i>=0; i--) {
-        assert(freearr[i]!=NULL);
-        free(freearr[i]);
-    }
-
-    bufn_num=free_num=0;
-}
-
-
-
-
-
-
-
-
-
-
-
-/* ***********************************************************************
-   Function to compare two strings originating from the *b1 and *b2
-   The size of the unrolled loop must be at most equal to the costant
-   Cmp_overshoot defined in common.h
-   the function return the result of the comparison (+ or -) and writes
-   in Cmp_done the number of successfull comparisons done
-   *********************************************************************** */
-static int32_t Cmp_done;
-
-int32_t cmp_unrolled_lcp(uint8_t* b1, uint8_t* b2)
-{
-
-    uint8_t c1, c2;
-    assert(b1 != b2);
-    Cmp_done=0;
-
-
-
-    do {
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  1; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  2; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  3; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  4; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  5; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  6; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  7; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  8; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done +=  9; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 10; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 11; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 12; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 13; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 14; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_done += 15; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        Cmp_done += 16;
-
-    } while (b1<Upper_text_limit && b2<Upper_text_limit);
-
-
-    return b2 - b1;
-}
-
-/* **************************************************************
-   ternary quicksort (seward-like) with lcp information
-   ************************************************************** */
-#define STACK_SIZE 100
-#define Swap(i,j) {tmp=a[i]; a[i]=a[j]; a[j]=tmp;}
-#define Pushd(x,y,z) {stack_lo[sp]=x; stack_hi[sp]=y; stack_d[sp]=z; sp++;}
-#define Popd(x,y,z)  {sp--; x=stack_lo[sp]; y=stack_hi[sp]; z=stack_d[sp];}
-void qs_unrolled_lcp(int32_t* a, int n, int depth, int blind_limit)
-{
-    void blind_ssort(int32_t *a, int32_t n, int32_t depth);
-    int32_t cmp_unrolled_lcp(uint8_t *b1, uint8_t *b2);
-    uint8_t* text_depth, *text_pos_pivot;
-    int32_t stack_lo[STACK_SIZE];
-    int32_t stack_hi[STACK_SIZE];
-    int32_t stack_d[STACK_SIZE];
-    int32_t sp,r,r3,med,tmp;
-    int32_t i, j, lo, hi,ris,lcp_lo,lcp_hi;
-
-
-    r=sp=0;
-    Pushd(0,n-1,depth);
-
-
-    while (sp > 0) {
-        assert(sp < STACK_SIZE);
-        Popd(lo,hi,depth);
-        text_depth = Text+depth;
-
-
-        if (hi-lo<blind_limit) {
-            blind_ssort(a+lo,hi-lo+1,depth);
-            continue;
-        }
-
-        /* Random partitioning. Guidance for the magic constants
-           7621 and 32768 is taken from Sedgewick's algorithms
-           book, chapter 35.
-        */
-        r = ((r * 7621) + 1) % 32768;
-        r3 = r % 3;
-        if (r3 == 0) med = lo; else if (r3 == 1) med = (lo+hi)>>1; else
-            med = hi;
-
-
-        Swap(med,hi);
-        text_pos_pivot=text_depth+a[hi];
-        i=lo-1; j=hi;
-        lcp_lo=lcp_hi=INT_MAX;
-        while (1) {
-            while (++i<hi) {
-                ris=cmp_unrolled_lcp(text_depth+a[i], text_pos_pivot);
-                if (ris>0) {
-                    if (Cmp_done < lcp_hi) lcp_hi=Cmp_done; break;
-                } else if (Cmp_done < lcp_lo) lcp_lo=Cmp_done;
-            }
-            while (--j>lo) {
-                ris=cmp_unrolled_lcp(text_depth+a[j], text_pos_pivot);
-                if (ris<0) {
-                    if (Cmp_done < lcp_lo) lcp_lo=Cmp_done;
-                    break;
-                } else if (Cmp_done < lcp_hi) lcp_hi=Cmp_done;
-            }
-            if (i >= j) break;
-            Swap(i,j);
-        }
-        Swap(i,hi);
-
-
-        assert(lcp_lo<INT_MAX || i==lo);
-        assert(lcp_hi<INT_MAX || i==hi);
-
-
-        if (i-lo < hi-i) {
-            Pushd(i+1,hi,depth+lcp_hi);
-            if (i-lo>1) Pushd(lo,i-1,depth+lcp_lo);
-        } else {
-            Pushd(lo,i-1,depth+lcp_lo);
-            if (hi-i>1) Pushd(i+1,hi,depth+lcp_hi);
-        }
-    }
-}
-
-
-
-/* ****************************************************************
-   routine for deep-sorting the suffixes a[0] ... a[n-1]
-   knowing that they have a common prefix of length "depth"
-  **************************************************************** */
-void deep_sort(int32_t* a, int32_t n, int32_t depth)
-{
-    void blind_ssort(int32_t *a, int32_t n, int32_t depth);
-    int blind_limit;
-
-    Calls_deep_sort++;
-    assert(n>1);
-
-    blind_limit=Text_size/Blind_sort_ratio;
-    if (n<=blind_limit)
-        blind_ssort(a,n,depth);
-    else
-        qs_unrolled_lcp(a,n,depth,blind_limit);
-}
-
-
-
-/* *****************************************************************
-   This procedure sort the strings a[0] ... a[n-1] with the help of an
-   anchor. The real sorting is done by the procedure
-   anchor_sort(). Here we choose the anchor.  The parameter depth is
-   the number of chars that a[0] ... a[n-1] are known to have in
-   common (thus a direct comparison among a[i] and a[j] should start
-   from position depth) Note that a[] is a subsection of the sa therefore
-   a[0] ... a[n-1] are starting position of suffixes
-   For every a[i] we look at the anchor a[i]/Anchor_dist and the one
-   after that. This justifies the definition of Anchor_num (the size of
-   Anchor_ofset[] and Anchor_rank[] defined in ds_sort()) as
-     Anchor_num = 2 + (n-1)/Anchor_dist
-   ***************************************************************** */
-void helped_sort(int32_t* a, int n, int depth)
-{
-    int32_t i, curr_sb, diff, toffset, aoffset;
-    int32_t text_pos, anchor_pos, anchor, anchor_rank;
-    int32_t min_forw_offset, min_forw_offset_buc, max_back_offset;
-    int32_t best_forw_anchor, best_forw_anchor_buc, best_back_anchor;
-    int32_t forw_anchor_index, forw_anchor_index_buc, back_anchor_index;
-
-    Calls_helped_sort++;
-    if (n==1) goto done_sorting;
-
-
-    if (Anchor_dist==0) {
-        pseudo_or_deep_sort(a, n, depth);
-        return;
-    }
-
-
-    curr_sb = Get_small_bucket(a[0]);
-
-
-    min_forw_offset = min_forw_offset_buc = INT_MAX;
-    max_back_offset = INT_MIN;
-    best_forw_anchor = best_forw_anchor_buc = best_back_anchor = -1;
-    forw_anchor_index = forw_anchor_index_buc = back_anchor_index = -1;
-
-    for (i=0; i<n; i++) {
-        text_pos = a[i];
-
-        anchor = text_pos/Anchor_dist;
-        toffset = text_pos % Anchor_dist;
-        aoffset = Anchor_offset[anchor];
-        if (aoffset<Anchor_dist) {
-            diff = aoffset - toffset;
-            assert(diff!=0);
-            if (diff>0) {
-                if (curr_sb!=Get_small_bucket(text_pos+diff)) {
-                    if (diff<min_forw_offset) {
-                        min_forw_offset = diff;
-                        best_forw_anchor = anchor;
-                        forw_anchor_index = i;
-                    }
-                } else {
-                    if (diff<min_forw_offset_buc) {
-                        min_forw_offset_buc = diff;
-                        best_forw_anchor_buc = anchor;
-                        forw_anchor_index_buc = i;
-                    }
-                }
-            } else {
-                if (diff>max_back_offset) {
-                    max_back_offset = diff;
-                    best_back_anchor = anchor;
-                    back_anchor_index = i;
-                }
-
-                aoffset = Anchor_offset[++anchor];
-                if (aoffset<Anchor_dist) {
-                    diff = Anchor_dist + aoffset - toffset;
-                    assert(diff>0);
-                    if (curr_sb!=Get_small_bucket(text_pos+diff)) {
-                        if (diff<min_forw_offset) {
-                            min_forw_offset = diff;
-                            best_forw_anchor = anchor;
-                            forw_anchor_index = i;
-                        }
-                    } else {
-                        if (diff<min_forw_offset_buc) {
-                            min_forw_offset_buc = diff;
-                            best_forw_anchor_buc = anchor;
-                            forw_anchor_index_buc = i;
-                        }
-                    }
-                }
-            }
-        }
-    }
-
-    if (best_forw_anchor>=0 && min_forw_offset<depth-1) {
-        Calls_anchor_sort_forw++;
-        assert(min_forw_offset<2*Anchor_dist);
-        anchor_pos = a[forw_anchor_index] + min_forw_offset;
-        anchor_rank = Anchor_rank[best_forw_anchor];
-        assert(Sa[anchor_rank]==anchor_pos);
-        general_anchor_sort(a,n,anchor_pos,anchor_rank,min_forw_offset);
-        goto done_sorting;
-    }
-
-    if (best_back_anchor>=0) {
-        uint8_t* T0, *Ti; int j;
-
-        assert(max_back_offset>-Anchor_dist && max_back_offset<0);
-
-        for (i=0; i<n; i++) {
-            if (a[i]+max_back_offset<0)
-                goto fail;
-        }
-
-        T0 = Text + a[0];
-        for (i=1; i<n; i++) {
-            Ti = Text + a[i];
-            for (j=max_back_offset; j<= -1; j++)
-                if (T0[j]!=Ti[j]) goto fail;
-        }
-
-        Calls_anchor_sort_backw++;
-        anchor_pos = a[back_anchor_index] + max_back_offset;
-        anchor_rank = Anchor_rank[best_back_anchor];
-        assert(Sa[anchor_rank]==anchor_pos);
-        general_anchor_sort(a,n,anchor_pos,anchor_rank,max_back_offset);
-        goto done_sorting;
-    }
-fail:
-
-    if (best_forw_anchor_buc>=0 && min_forw_offset_buc<depth-1) {
-        int equal,lower,upper;
-
-        assert(min_forw_offset_buc<2*Anchor_dist);
-        anchor_pos = a[forw_anchor_index_buc] + min_forw_offset_buc;
-        anchor_rank = Anchor_rank[best_forw_anchor_buc];
-        assert(Sa[anchor_rank]==anchor_pos);
-
-
-        equal=split_group(a,n,depth,min_forw_offset_buc,
-                          forw_anchor_index_buc,&lower);
-        if (equal==n) {
-            Calls_anchor_sort_forw++;
-            general_anchor_sort(a,n,anchor_pos,anchor_rank,min_forw_offset_buc);
-        } else {
-
-            upper = n-equal-lower;
-            assert(upper>=0);
-
-
-            Calls_anchor_sort_forw++;
-            if (equal>1)
-                general_anchor_sort(a+lower,equal,anchor_pos,anchor_rank,
-                                    min_forw_offset_buc);
-
-
-            if (lower>1) pseudo_or_deep_sort(a,lower,depth);
-            if (upper>1) pseudo_or_deep_sort(a+lower+equal,upper,depth);
-        }
-        goto done_sorting;
-    }
-
-
-
-
-
-    pseudo_or_deep_sort(a, n, depth);
-done_sorting:
-
-    if (Anchor_dist>0) update_anchors(a, n);
-}
-
-
-
-/* *******************************************************************
-   try pseudo_anchor sort or deep_sort
-   ******************************************************************** */
-void pseudo_or_deep_sort(int32_t* a, int32_t n, int32_t depth)
-{
-
-    int32_t offset, text_pos, sb, pseudo_anchor_pos, max_offset, size;
-
-
-    if (Max_pseudo_anchor_offset>0) {
-
-        max_offset = MIN(depth-1,Max_pseudo_anchor_offset);
-        text_pos = a[0];
-        for (offset=1; offset<max_offset; offset++) {
-            pseudo_anchor_pos = text_pos+offset;
-            sb = Get_small_bucket(pseudo_anchor_pos);
-
-            if (IS_SORTED_BUCKET(sb)) {
-                size=BUCKET_SIZE(sb);
-                if (size>B2g_ratio*n) continue;
-
-                pseudo_anchor_sort(a,n,pseudo_anchor_pos,offset);
-                Calls_pseudo_anchor_sort_forw++;
-                return;
-            }
-        }
-    }
-    deep_sort(a,n,depth);
-}
-
-/* ********************************************************************
-   this routine sorts the suffixes a[0] ... a[n-1] using the fact that
-   in their common prefix, after offset characters, there is a
-   suffix which is in an already sorted bucket. This suffix is called
-   a pseudo anchor since it is used essentially as an anchor, but
-   it is not in an anchor position (=position multiple of Anchor_dist)
-   ******************************************************************** */
-void pseudo_anchor_sort(int32_t* a,int32_t n,int32_t pseudo_anchor_pos, int32_t offset)
-{
-    int32_t get_rank(int32_t);
-    int32_t get_rank_update_anchors(int32_t);
-    int32_t pseudo_anchor_rank;
-
-
-    if (Update_anchor_ranks!=0 && Anchor_dist>0)
-        pseudo_anchor_rank = get_rank_update_anchors(pseudo_anchor_pos);
-    else
-        pseudo_anchor_rank = get_rank(pseudo_anchor_pos);
-
-    assert(Sa[pseudo_anchor_rank]==pseudo_anchor_pos);
-
-    general_anchor_sort(a,n,pseudo_anchor_pos,pseudo_anchor_rank,offset);
-}
-
-
-/* ********************************************************
-   macros for marking integers: works assuming integers have
-   at least 32 bit and that the 32nd bit is not used
-   This simply means that the text size can be at most 2GB
-   ********************************************************* */
-#define MARKER (1<<31)
-#define MARK(i) {                \
-  assert(( Sa[i]&MARKER) == 0);  \
-  (Sa[i] |= MARKER);             \
-}
-#define ISMARKED(i) (Sa[i] & MARKER)
-#define UNMARK(i) (Sa[i] &= ~MARKER)
-
-/* ********************************************************************
-   This routines sorts a[0] ... a[n-1] using the fact that
-   in their common prefix, after offset characters, there is a
-   suffix whose rank is known. In this routine we call this suffix anchor
-   (and we denote its position and rank with anchor_pos and anchor_rank
-   respectively) but it is not necessarily an anchor (=does not necessarily
-   starts at position multiple of Anchor_dist) since this function is
-   called by pseudo_anchor_sort().
-   The routine works by scanning the suffixes before and after the anchor
-   in order to find (and mark) those which are suffixes of a[0] ... a[n-1].
-   After that, the ordering of a[0] ... a[n-1] is derived with a sigle
-   scan of the marked suffixes.
-   ******************************************************************** */
-void general_anchor_sort(int32_t* a, int32_t n,
-                         int32_t anchor_pos, int32_t anchor_rank, int32_t offset)
-{
-    int integer_cmp(const void*, const void*);
-    int32_t sb, lo, hi;
-    int32_t curr_lo, curr_hi, to_be_found, i,j;
-    int32_t item;
-    void* ris;
-
-    assert(Sa[anchor_rank]==anchor_pos);
-    /* ---------- get bucket of anchor ---------- */
-    sb = Get_small_bucket(anchor_pos);
-    lo = BUCKET_FIRST(sb);
-    hi = BUCKET_LAST(sb);
-    assert(sb==Get_small_bucket(a[0]+offset));
-
-    qsort(a,n, sizeof(int32_t), integer_cmp);
-
-
-
-
-
-
-    curr_hi = curr_lo = anchor_rank;
-
-
-#if DEBUG
-    item = anchor_pos-offset;
-    assert(bsearch(&item,a,n,sizeof(int32_t), integer_cmp));
-#endif
-
-    MARK(curr_lo);
-
-    for (to_be_found=n-1; to_be_found>0;) {
-
-        assert(curr_lo > lo || curr_hi < hi);
-        while (curr_lo > lo) {
-            item = Sa[--curr_lo]-offset;
-            ris = bsearch(&item,a,n,sizeof(int32_t), integer_cmp);
-            if (ris)	{
-                MARK(curr_lo);
-                to_be_found--;
-            } else	break;
-        }
-        while (curr_hi < hi) {
-            item = Sa[++curr_hi]-offset;
-            ris = bsearch(&item,a,n,sizeof(int32_t), integer_cmp);
-            if (ris)	{
-                MARK(curr_hi);
-                to_be_found--;
-            } else      break;
-        }
-    }
-
-    for (j=0, i=curr_lo; i<=curr_hi; i++)
-        if (ISMARKED(i)) {
-            UNMARK(i);
-            a[j++] = Sa[i] - offset;
-        }
-    assert(j==n);
-}
-
-/* ********************************************************************
-   compute the rank of the suffix starting at pos.
-   It is required that the suffix is in an already sorted bucket
-   ******************************************************************** */
-int32_t get_rank(int32_t pos)
-{
-    int32_t sb, lo, hi, j;
-
-    sb = Get_small_bucket(pos);
-    if (!IS_SORTED_BUCKET(sb)) {
-        fprintf(stderr,"Illegal call to get_rank! (get_rank1)\n");
-        exit(1);
-    }
-    lo = BUCKET_FIRST(sb);
-    hi = BUCKET_LAST(sb);
-    for (j=lo; j<=hi; j++)
-        if (Sa[j]==pos) return j;
-    fprintf(stderr,"Illegal call to get_rank! (get_rank2)\n");
-    exit(1);
-    return 1;
-}
-
-/* ********************************************************************
-   compute the rank of the suffix starting at pos. At the same time
-   check if the rank of the suffixes in the bucket containing pos
-   can be used to update some entries in Anchor_offset[] and Anchor_rank[]
-   It is required that the suffix is in an already sorted bucket
-   ******************************************************************** */
-uint8_t bucket_ranked[65536];
-int32_t get_rank_update_anchors(int32_t pos)
-{
-    int32_t get_rank(int32_t pos);
-    int32_t sb, lo, hi, j, toffset, aoffset, anchor, rank;
-
-    assert(Anchor_dist>0);
-
-    sb = Get_small_bucket(pos);
-    if (!(IS_SORTED_BUCKET(sb))) {
-        fprintf(stderr,"Illegal call to get_rank! (get_rank_update_anchors)\n");
-        exit(1);
-    }
-
-    if (bucket_ranked[sb]) return get_rank(pos);
-
-    bucket_ranked[sb]=1;
-    rank = -1;
-    lo = BUCKET_FIRST(sb);
-    hi = BUCKET_LAST(sb);
-    for (j=lo; j<=hi; j++) {
-
-        toffset = Sa[j]%Anchor_dist;
-        anchor  = Sa[j]/Anchor_dist;
-        aoffset = Anchor_offset[anchor];
-        if (toffset<aoffset) {
-            Anchor_offset[anchor] = toffset;
-            Anchor_rank[anchor] = j;
-        }
-
-        if (Sa[j]==pos) {
-            assert(rank==-1); rank=j;
-        }
-    }
-    assert(rank>=0);
-    return rank;
-}
-
-
-/* ******************************************************************
-   comparison function used to sort pointers as if they were integers
-   if a pointer does not correspond to an int32_t we must change the
-   function accordingly
-   ****************************************************************** */
-int integer_cmp(const void* a, const void* b)
-{
-    return *((int32_t*) a) -  *((int32_t*) b);
-}
-
-/* ****************************************************************
-   given a SORTED array of suffixes a[0] .. a[n-1]
-   updates Anchor_rank[] and Anchor_offset[]
-   **************************************************************** */
-void update_anchors(int32_t* a, int32_t n)
-{
-    int32_t i,anchor,toffset,aoffset,text_pos;
-
-    assert(Anchor_dist>0);
-    for (i=0; i<n; i++) {
-        text_pos = a[i];
-
-        anchor = text_pos/Anchor_dist;
-        toffset = text_pos % Anchor_dist;
-        aoffset = Anchor_offset[anchor];
-        if (toffset<aoffset) {
-            Anchor_offset[anchor] = toffset;
-            Anchor_rank[anchor] = (a - Sa) + i;
-            assert(Sa[Anchor_rank[anchor]]==
-                   anchor*Anchor_dist+Anchor_offset[anchor]);
-        }
-    }
-}
-
-
-
-/* *******************************************************************
-   This function takes as input an array a[0] .. a[n-1] of suffixes
-   which share the first "depth" chars. "pivot" in an index in 0..n-1
-   and offset and integer>0. The function splits a[0] .. a[n-1]
-   into 3 groups: first the suffixes which are smaller than a[pivot],
-   then those which are equal to a[pivot] and finally those which are
-   greater than a[pivot]. Here, smaller, equal, larger refer to
-   a lexicographic ordering limited to the first depth+offest chars
-   (since the first depth chars are equal we only look at the chars
-   in position depth, depth+1, ... depth+offset-1).
-   The function returns the number "num" of suffixes equal to a[pivot],
-   and stores in *first the first of these suffixes. So at the end
-   the smaller suffixes are in a[0] ... a[first-1],
-   the equal suffixes in a[first] ... a[first+num-1],
-   the larger suffixes in a[first+num] ... a[n-1]
-   The splitting is done using a modified mkq()
-   ******************************************************************* */
-#define swap2(a, b) { t = *(a); *(a) = *(b); *(b) = t; }
-#define ptr2char(i) (*(*(i) + text_depth))
-
-int32_t split_group(int32_t* a, int n, int depth,int offset,int32_t pivot,int* first)
-{
-    void vecswap2(int32_t *a, int32_t *b, int n);
-    int r, partval;
-    int32_t* pa, *pb, *pc, *pd, *pa_old, *pd_old, pivot_pos, t;
-    uint8_t* text_depth,*text_limit;
-
-
-    pivot_pos = a[pivot];
-    text_depth = Text+depth;
-    text_limit = text_depth+offset;
-
-
-
-    pa = a; pd = a + n-1;
-
-    for (; pa!=pd && (text_depth<text_limit); text_depth++) {
-        assert(pa<pd);
-
-
-        partval = text_depth[pivot_pos];
-
-        pb = pa_old = pa;
-        pc = pd_old = pd;
-        for (;;) {
-            while (pb <= pc && (r = ptr2char(pb)-partval) <= 0) {
-                if (r == 0) {
-                    swap2(pa, pb);
-                    pa++;
-                }
-                pb++;
-            }
-            while (pb <= pc && (r = ptr2char(pc)-partval) >= 0) {
-                if (r == 0) {
-                    swap2(pc, pd);
-                    pd--;
-                }
-                pc--;
-            }
-            if (pb > pc) break;
-            swap2(pb, pc);
-            pb++;
-            pc--;
-        }
-        r = MIN(pa-pa_old, pb-pa); vecswap2(pa_old,  pb-r, r);
-        r = MIN(pd-pc, pd_old-pd); vecswap2(pb, pd_old+1-r, r);
-
-        pa = pa_old + (pb-pa);
-        pd = pd_old - (pd-pc);
-
-    }
-    *first=pa-a;
-    assert(pd-pa>=0);
-    return pd-pa+1;
-}
-
-
-
-
-
-
-/* >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
-   shallow.c
-   This is the multikey quicksort from bentley-sedgewick modified
-   so that it stops recursion when depth reaches  Shallow_limit
-   (that is when two or more suffixes have Shallow_limit chars in common).
-   >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
-#include <stdlib.h>
-#include <string.h>
-#include <stdio.h>
-
-
-extern uint8_t* Text;
-extern uint8_t* Upper_text_limit;
-extern int32_t _ds_Word_size;
-extern int32_t Mk_qs_thresh;
-
-
-
-
-int32_t Shallow_limit;
-uint8_t* Shallow_text_limit;
-
-#define UNROLL 1
-
-
-
-
-
-void shallow_sort(int32_t* a, int n, int shallow_limit)
-{
-
-    Shallow_limit = shallow_limit;
-    Shallow_text_limit = Text + shallow_limit;
-
-
-    switch (_ds_Word_size) {
-        case(1): shallow_mkq(a, n, Text+2); break;
-        case(2): shallow_mkq16(a, n, Text+2); break;
-        case(4): shallow_mkq32(a, n, Text+2); break;
-        default:
-            fprintf(stderr,
-                    "Invalid word size for mkqs (%d) (shallow_sort)\n",_ds_Word_size);
-            exit(1);
-    }
-}
-
-
-/* =======================================================
-   auxiliary procedures and macro for bentley-sedgewick's
-   multikey quicksort
-   ======================================================= */
-void vecswap2(int32_t* a, int32_t* b, int n)
-{
-    while (n-- > 0) {
-        int32_t t = *a;
-        *a++ = *b;
-        *b++ = t;
-    }
-}
-
-#define swap2(a, b) { t = *(a); *(a) = *(b); *(b) = t; }
-#define ptr2char(i) (*(*(i) + text_depth))
-
-int32_t* med3func(int32_t* a, int32_t* b, int32_t* c, uint8_t* text_depth)
-{
-    int va, vb, vc;
-    if ((va=ptr2char(a)) == (vb=ptr2char(b)))
-        return a;
-    if ((vc=ptr2char(c)) == va || vc == vb)
-        return c;
-    return va < vb ?
-           (vb < vc ? b : (va < vc ? c : a))
-               : (vb > vc ? b : (va < vc ? a : c));
-}
-#define med3(a, b, c) med3func(a, b, c, text_depth)
-
-
-/* ********************************************************
-   recursive multikey quicksort from Bentley-Sedgewick
-   stops when text_depth reaches Shallow_depth_limit
-   that is when we have found that the current set of strings
-   have Shallow_limit chars in common
-   ******************************************************** */
-void shallow_mkq(int32_t* a, int n, uint8_t* text_depth)
-{
-    void vecswap2(int32_t *a, int32_t *b, int n);
-    int d, r, partval;
-    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t;
-    uint8_t* next_depth;
-
-
-    if (n < Mk_qs_thresh) {
-        shallow_inssort_lcp(a, n, text_depth);
-        return;
-    }
-
-
-repeat:
-    pl = a;
-    pm = a + (n/2);
-    pn = a + (n-1);
-    if (n > 30) {
-        d = (n/8);
-        pl = med3(pl, pl+d, pl+2*d);
-        pm = med3(pm-d, pm, pm+d);
-        pn = med3(pn-2*d, pn-d, pn);
-    }
-    pm = med3(pl, pm, pn);
-    swap2(a, pm);
-    partval = ptr2char(a);
-    pa = pb = a + 1;
-    pc = pd = a + n-1;
-
-    for (;;) {
-        while (pb <= pc && (r = ptr2char(pb)-partval) <= 0) {
-            if (r == 0) {
-                swap2(pa, pb);
-                pa++;
-            }
-            pb++;
-        }
-        while (pb <= pc && (r = ptr2char(pc)-partval) >= 0) {
-            if (r == 0) {
-                swap2(pc, pd);
-                pd--;
-            }
-            pc--;
-        }
-        if (pb > pc) break;
-        swap2(pb, pc);
-        pb++;
-        pc--;
-    }
-
-#if UNROLL
-    if (pa>pd) {
-
-        if ((next_depth = text_depth+1) >= Shallow_text_limit) {
-            helped_sort(a, n, next_depth-Text);
-            return;
-        } else {
-            text_depth = next_depth;
-            goto repeat;
-        }
-    }
-#endif
-
-    pn = a + n;
-    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
-    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
-
-    if ((r = pb-pa) > 1)
-        shallow_mkq(a, r, text_depth);
-
-    if ((next_depth = text_depth+1) < Shallow_text_limit)
-        shallow_mkq(a + r, pa-pd+n-1, next_depth);
-    else
-        helped_sort(a + r, pa-pd+n-1, next_depth-Text);
-    if ((r = pd-pc) > 1)
-        shallow_mkq(a + n-r, r, text_depth);
-}
-
-
-
-/* ************** 16 *************** */
-#define ptr2char16(i) (getword16(*(i) + text_depth))
-#define getword16(s) ((unsigned)((*(s) << 8) | *((s)+1)))
-
-#if 0
-__inline__ int32_t* med3func16(int32_t* a, int32_t* b, int32_t* c, uint8_t* text_depth)
-{
-    int va, vb, vc;
-    if ((va=ptr2char16(a)) == (vb=ptr2char16(b)))
-        return a;
-    if ((vc=ptr2char16(c)) == va || vc == vb)
-        return c;
-    return va < vb ?
-           (vb < vc ? b : (va < vc ? c : a))
-               : (vb > vc ? b : (va < vc ? a : c));
-}
-#define med3_16(a, b, c) med3func16(a, b, c, text_depth)
-#endif
-
-void shallow_mkq16(int32_t* a, int n, uint8_t* text_depth)
-{
-    void vecswap2(int32_t *a, int32_t *b, int n);
-    int d, r, partval;
-    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t;
-    uint8_t* next_depth;
-
-
-    if (n < Mk_qs_thresh) {
-        shallow_inssort_lcp(a, n, text_depth);
-        return;
-    }
-
-
-repeat:
-    pl = a;
-    pm = a + (n/2);
-    pn = a + (n-1);
-    if (n > 30) {
-        d = (n/8);
-        pl = med3(pl, pl+d, pl+2*d);
-        pm = med3(pm-d, pm, pm+d);
-        pn = med3(pn-2*d, pn-d, pn);
-    }
-    pm = med3(pl, pm, pn);
-    swap2(a, pm);
-    partval = ptr2char16(a);
-    pa = pb = a + 1;
-    pc = pd = a + n-1;
-
-    for (;;) {
-        while (pb <= pc && (r = ptr2char16(pb)-partval) <= 0) {
-            if (r == 0) {
-                swap2(pa, pb);
-                pa++;
-            }
-            pb++;
-        }
-        while (pb <= pc && (r = ptr2char16(pc)-partval) >= 0) {
-            if (r == 0) {
-                swap2(pc, pd);
-                pd--;
-            }
-            pc--;
-        }
-        if (pb > pc) break;
-        swap2(pb, pc);
-        pb++;
-        pc--;
-    }
-#if UNROLL
-    if (pa>pd) {
-
-        if ((next_depth = text_depth+2) >= Shallow_text_limit) {
-            helped_sort(a, n, next_depth-Text);
-            return;
-        } else {
-            text_depth = next_depth;
-            goto repeat;
-        }
-    }
-#endif
-
-    pn = a + n;
-    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
-    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
-
-    if ((r = pb-pa) > 1)
-        shallow_mkq16(a, r, text_depth);
-
-    if ((next_depth = text_depth+2) < Shallow_text_limit)
-        shallow_mkq16(a + r, pa-pd+n-1, next_depth);
-    else
-        helped_sort(a + r, pa-pd+n-1, next_depth-Text);
-    if ((r = pd-pc) > 1)
-        shallow_mkq16(a + n-r, r, text_depth);
-}
-
-
-/* *************** 32 **************** */
-#define ptr2char32(i) (getword32(*(i) + text_depth))
-#define getword32(s) ((unsigned)( (*(s) << 24) | ((*((s)+1)) << 16) \
-                                  | ((*((s)+2)) << 8) | (*((s)+3)) ))
-void shallow_mkq32(int32_t* a, int n, uint8_t* text_depth)
-{
-    void vecswap2(int32_t *a, int32_t *b, int n);
-    uint32_t partval, val;
-    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t, d, r;
-    uint8_t* next_depth;
-
-
-    if (n < Mk_qs_thresh) {
-        shallow_inssort_lcp(a, n, text_depth);
-        return;
-    }
-
-
-repeat:
-    pl = a;
-    pm = a + (n/2);
-    pn = a + (n-1);
-    if (n > 30) {
-        d = (n/8);
-        pl = med3(pl, pl+d, pl+2*d);
-        pm = med3(pm-d, pm, pm+d);
-        pn = med3(pn-2*d, pn-d, pn);
-    }
-    pm = med3(pl, pm, pn);
-    swap2(a, pm);
-    partval = ptr2char32(a);
-    pa = pb = a + 1;
-    pc = pd = a + n-1;
-
-    for (;;) {
-        while (pb <= pc && (val=ptr2char32(pb)) <=  partval) {
-            if (val == partval) {
-                swap2(pa, pb);
-                pa++;
-            }
-            pb++;
-        }
-        while (pb <= pc && (val=ptr2char32(pc)) >= partval) {
-            if (val == partval) {
-                swap2(pc, pd);
-                pd--;
-            }
-            pc--;
-        }
-        if (pb > pc) break;
-        swap2(pb, pc);
-        pb++;
-        pc--;
-    }
-#if UNROLL
-    if (pa>pd) {
-
-        if ((next_depth = text_depth+4) >= Shallow_text_limit) {
-            helped_sort(a, n, next_depth-Text);
-            return;
-        } else {
-            text_depth = next_depth;
-            goto repeat;
-        }
-    }
-#endif
-
-    pn = a + n;
-    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
-    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
-
-    if ((r = pb-pa) > 1)
-        shallow_mkq32(a, r, text_depth);
-
-    if ((next_depth = text_depth+4) < Shallow_text_limit)
-        shallow_mkq32(a + r, pa-pd+n-1, next_depth);
-    else
-        helped_sort(a + r, pa-pd+n-1, next_depth-Text);
-    if ((r = pd-pc) > 1)
-        shallow_mkq32(a + n-r, r, text_depth);
-}
-
-
-
-/* >>>>>>>>>>>>>>>>>>>>>> insertion sort routines >>>>>>>>>>>>>>>>>>>
-   This insertion sort routines sorts the suffixes a[0] .. a[n-1]
-   which have a common prexif of length text_depth-Text.
-   The comparisons are done going at most at depth Shallow_limit;
-   suffixes which have Shallow_limit chars in common are sorted using
-   helped_sort().
-   This inserion_sort keeps trak of the lcp in order to speed up
-   the sorting.
-  >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
-
-/* ***********************************************************************
-   Function to compare two strings originating from the *b1 and *b2
-   The size of the unrolled loop must be at most equal to the costant
-   Cmp_overshoot defined in common.h
-   When the function is called Cmp_left must contain the maximum number of
-   comparisons the algorithm can do before returning 0 (equal strings)
-   At exit Cmp_left has been decreased by the # of comparisons done
-   *********************************************************************** */
-static int32_t Cmp_left;
-
-int32_t cmp_unrolled_shallow_lcp(uint8_t* b1, uint8_t* b2)
-{
-
-    uint8_t c1, c2;
-    assert(b1 != b2);
-
-
-
-    do {
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  1; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  2; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  3; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  4; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  5; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  6; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  7; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  8; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -=  9; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 10; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 11; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 12; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 13; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 14; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        c1 = *b1; c2 = *b2;
-        if (c1 != c2) {
-            Cmp_left -= 15; return ((uint32_t)c1 - (uint32_t)c2);
-        }
-        b1++; b2++;
-
-        Cmp_left -= 16;
-        if (Cmp_left<=0) return 0;
-
-    } while (1);
-
-    return b2 - b1;
-}
-
-/* *****************************************************************
-   this is the insertion sort routine called by multikey-quicksort
-   for sorting small groups.
-   During insertion sort the comparisons are done calling
-   cmp_unrolled_shallow_lcp() and two strings are equal if the coincides
-   for Shallow_limit characters.
-   After this first phase we sort groups of "equal_string" using
-   helped_sort().
-   Usage of lcp.
-   For i=1,...n-1 let lcp[i] denote the lcp between a[i] and a[i+1].
-   assume a[0] ... a[j-1] are already ordered and that we want to
-   insert a new element ai. If suf(ai) >= suf(a[j-1]) we are done.
-   If suf(ai)<suf(a[j-1]) we notice that: if lcpi>lcp[j-2] then
-   suf(ai)>suf(a[j-2]) and we can stop since
-   j-2 mmmmmmg
-   j-1 mmmmmmmmmmmm
-   ai  mmmmmmmmmmmf ] lcpi
-   so we write a[j-1] in position j and ai in position j-1.
-   if lcpi==lcp[j-2] then we need to compare suf(ai) with suf(a[j-2])
-   j-2 mmmmmmmmmmm?     we can have either ?<f or ?>f or ?==f
-   j-1 mmmmmmmmmmmm
-   j   mmmmmmmmmmmf
-   so we move a[j-1] to position j and compare suf(ai) with suf(a[j-2])
-   starting from lcpi.
-   Finally, if lcpi<lcp[j-2] then
-   j-2 mmmmmmmmmmmmmmmmmmg
-   j-1 mmmmmmmmmmmmmmmmmmm
-   j   mmmmmmmmmmmmmf
-   hence we have suf(ai)<suf(a[j-2]) and we consider a[j-3];
-   if lcpi<lcp[j-3] we go on look at a[j-4] and go on.
-   if lcp[j]>lcp[j-3] we are in the following position:
-   j-3 mmmmmmc
-   j-2 mmmmmmmmmmmmmmmg
-   j-1 mmmmmmmmmmmmmmmm
-   j   mmmmmmmmmmf
-   and we know that suf(ai) is larger than suf(a[j-3]). If we find that
-   lcpi==lcp[j-3] then we must compare suf(ai) with suf(a[j-3])
-   but starting with position lcpi
-   ***************************************************************** */
-static int lcp_aux[1+Max_thresh];
-static int* lcp=lcp_aux+1;
-void shallow_inssort_lcp(int32_t* a, int32_t n, uint8_t* text_depth)
-{
-    int32_t cmp_unrolled_shallow_lcp(uint8_t*, uint8_t*);
-    int32_t i, j, j1, lcp_new, r, ai,lcpi;
-    int32_t cmp_from_limit;
-    uint8_t* text_depth_ai;
-
-
-    lcp_aux[0] = -1;
-    for (i=0; i<n; i++) lcp[i]=0;
-
-    cmp_from_limit = Shallow_text_limit-text_depth;
-
-
-    for (i = 1; i< n ; i++) {
-        ai = a[i]; lcpi = 0;
-        text_depth_ai = ai + text_depth;
-        j=i; j1=j-1;
-        while (1) {
-
-
-            Cmp_left = cmp_from_limit-lcpi;
-            r = cmp_unrolled_shallow_lcp(lcpi+a[j1]+text_depth,lcpi+text_depth_ai);
-            lcp_new = cmp_from_limit - Cmp_left;
-            assert(r!=0 || lcp_new>= cmp_from_limit);
-
-            if (r<=0) {
-                lcp[j1]=lcp_new;
-                break;
-            }
-
-
-
-            lcpi = lcp_new;
-            do {
-                a[j] = a[j1];
-                lcp[j] = lcp[j1];
-                j=j1; j1--;
-            } while (lcpi<lcp[j1]);
-
-            if (lcpi>lcp[j1]) break;
-
-
-
-        }
-        a[j]=ai;
-        lcp[j]=lcpi;
-    }
-
-
-    for (i=0; i<n-1; i=j+1) {
-        for (j=i; j<n ; j++)
-            if (lcp[j]<cmp_from_limit) break;
-        if (j-i>0)
-            helped_sort(a+i,j-i+1,Shallow_limit);
-    }
-}
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-/* *******************************************************************
-   procedure to be called by external program before calling ds_ssort()
-   using this procedure external programs can choose
-   the parameters Anchor_dist and Blind_sort_ratio.
-   The procedure returns 0 if something goes wrong, otherwise
-   it returns the overshhot, that is the amount of extra space
-   required at the end of the array contanining the text
-   ******************************************************************** */
-int init_ds_ssort(int adist, int bs_ratio)
-{
-    set_global_variables();
-    Anchor_dist = adist;
-    Blind_sort_ratio=bs_ratio;
-    Shallow_limit =  Anchor_dist + 50;
-    if (check_global_variables())
-        return 0;
-    return compute_overshoot();
-}
-
-
-
-void set_global_variables(void)
-{
-    Blind_sort_ratio=2000;
-    Anchor_dist = 500;
-    Shallow_limit = 550;
-    _ds_Verbose = 0;
-    _ds_Word_size = 4;
-    Mk_qs_thresh=20;
-    Max_pseudo_anchor_offset=0;
-    B2g_ratio=1000;
-    Update_anchor_ranks=0;
-}
-
-
-
-int check_global_variables(void)
-{
-    if ((Anchor_dist<100) && (Anchor_dist!=0)) {
-        fprintf(stderr,"Anchor distance must be 0 or greater than 99\n");
-        return 1;
-    }
-    if (Anchor_dist>65535) {
-        fprintf(stderr,"Anchor distance must be less than 65536\n");
-        return 1;
-    }
-    if (Shallow_limit<2) {
-        fprintf(stderr,"Illegal limit for shallow sort\n");
-        return 1;
-    }
-    if (Mk_qs_thresh<0 || Mk_qs_thresh>Max_thresh) {
-        fprintf(stderr,"Illegal Mk_qs_thresh parameter!\n");
-        return 1;
-    }
-    if (Blind_sort_ratio<=0) {
-        fprintf(stderr,"blind_sort ratio must be greater than 0!\n");
-        return 1;
-    }
-    return 0;
-}
-
-
-
-
-int compute_overshoot(void)
-{
-    return 9+(Shallow_limit+Cmp_overshoot);
-}
-
-
-void pretty_putchar(int c)
-{
-
-    if (c>=32 && c<127)
-        printf("  %c", c);
-    else if (c=='\n')
-        printf(" \\n");
-    else if (c=='\t')
-        printf(" \\t");
-    else
-        printf(" %02x", c);
-}
-
-
-int scmp3(unsigned char* p, unsigned char* q, int* l, int maxl)
-{
-    int i;
-    i = 0;
-    while (maxl>0 && *p==*q) {
-        p++; q++; i++;
-        maxl--;
-    }
-    *l = i;
-    if (maxl>0) return *p-*q;
-    return q-p;
-}
-
-
-
-
-
-
-extern int Anchor_dist;
-extern int Shallow_limit;
-extern int _ds_Verbose;
-
-
-#define BIGFREQ(b) (ftab[((b)+1) << 8] - ftab[(b) << 8])
-
-
-/* ------ "local" global variables ------- */
-int32_t  Text_size;
-uint8_t*  Text;
-int32_t*  Sa;
-uint8_t*  Upper_text_limit;
-int32_t*  Anchor_rank;
-
-uint16_t*  Anchor_offset;
-
-int32_t Anchor_num;
-int32_t ftab [65537];
-int32_t runningOrder[256];
-
-
-/* ------------------------------------------------------------------------
-   The use of Anchor_rank[] and Anchor_offset is the following:
-   Anchor_rank[i] is either -1 or contains the rank (in the list of
-   the sorted suffixes of the suffix starting at position
-     i*Anchor_dist + Anchor_offset[i].
-   Initially Anchor_rank[i] = -1 and Anchor_offset[i]=Anchor_dist,
-   then, if a suffix in position t (i*Anchor_dist <= t < (i+1)*Anchor_dist)
-   appears to be in a large group which is sorted, the rank of
-   t is stored in Anchor_rank[i], and the value t-(i*Anchor_dist)
-   is written to Anchor_offset[i]. Both vaulues can be later updated,
-   but the value in Anchor_offset[i] can only decrease, so no further
-   changes are done when Anchor_offset[i] is = 0. The invariant is:
-   if Anchor_rank[i]>=0 then
-       Sa[Anchor_rank[i]]=i*Anchor_dist+Anchor_offset[i]
-   -------------------------------------------------------------------------*/
-
-
-
-void check_ordering(int, int);
-void calc_running_order(void);
-
-
-/* ************************************************************
-   This is the main deep/shallow suffix sorting routines
-   It divides the suffixes in buckets according to the
-   first two characters. Some of the buckets are then sorted
-   calling shallow_sort(). When all buckets of kind ax (x!=a) are
-   sorted, we use this ordering to sort all suffixes in the
-   buckets ya (for any y including y=a).
-   ************************************************************* */
-void ds_ssort(uint8_t* x, int32_t* p, int32_t n)
-{
-    void shallow_sort(int32_t*, int, int);
-    int compute_overshoot(void), overshoot;
-    int32_t  i, j, ss, sb, k;
-    uint8_t  c1, c2;
-    uint8_t   bigDone[256];
-    int32_t  copyStart[256];
-    int32_t  copyEnd  [256];
-    int32_t  numQSorted = 0;
-
-
-    Text=x;
-    Text_size=n;
-    Sa = p;
-    Upper_text_limit = Text + Text_size;
-
-    overshoot = compute_overshoot();
-    for (i=n; i<n+overshoot; i++) Text[i]=0;
-
-
-    if (Anchor_dist==0) {
-        Anchor_num=0; Anchor_rank=NULL; Anchor_offset=NULL;
-    } else {
-        Anchor_num = 2 + (n-1)/Anchor_dist;
-        Anchor_rank = (int32_t*) malloc(Anchor_num*sizeof(int32_t));
-        Anchor_offset = (uint16_t*) malloc(Anchor_num*sizeof(uint16_t));
-        if (!Anchor_rank || !Anchor_offset) {
-            fprintf(stderr, "malloc failed (ds_sort)\n");
-            exit(1);
-        }
-        for (i=0; i<Anchor_num; i++) {
-            Anchor_rank[i]= -1;
-            Anchor_offset[i] = Anchor_dist;
-        }
-    }
-
-
-    for (i = 0; i <= 65536; i++) ftab[i] = 0;
-    c1 = Text[0];
-    for (i = 1; i <= Text_size; i++) {
-        c2 = Text[i];
-        ftab[(c1 << 8) + c2]++;
-        c1 = c2;
-    }
-    for (i = 1; i <= 65536; i++) ftab[i] += ftab[i-1];
-
-
-    c1 = Text[0];
-    for (i = 0; i < Text_size; i++) {
-        c2 = Text[i+1];
-        j = (c1 << 8) + c2;
-        c1 = c2;
-        ftab[j]--;
-        Sa[ftab[j]] = i;
-    }
-
-    /* decide on the running order */
-    calc_running_order();
-    for (i = 0; i < 256; i++) bigDone[i] = FALSE;
-
-    /* Really do the suffix sorting */
-    for (i = 0; i <= 255; i++) {
-
-        /*--
-          Process big buckets, starting with the least full.
-          --*/
-        ss = runningOrder[i];
-        if (_ds_Verbose>2)
-            fprintf(stderr,"group %3d;  size %d\n",ss,BIGFREQ(ss)&CLEARMASK);
-
-        /*--
-          Complete the big bucket [ss] by sorting
-          any unsorted small buckets [ss, j].  Hopefully
-          previous pointer-scanning phases have already
-          completed many of the small buckets [ss, j], so
-          we don't have to sort them at all.
-          --*/
-        for (j = 0; j <= 255; j++) {
-            if (j != ss) {
-                sb = (ss << 8) + j;
-                if (!(ftab[sb] & SETMASK)) {
-                    int32_t lo = ftab[sb]   & CLEARMASK;
-                    int32_t hi = (ftab[sb+1] & CLEARMASK) - 1;
-                    if (hi > lo) {
-                        if (_ds_Verbose>2)
-                            fprintf(stderr,"sorting [%02x, %02x], done %d "
-                                    "this %d\n", ss, j, numQSorted, hi - lo + 1);
-                        shallow_sort(Sa+lo, hi-lo+1,Shallow_limit);
-#if 0
-                        check_ordering(lo, hi);
-#endif
-                        numQSorted += (hi - lo + 1);
-                    }
-                }
-                ftab[sb] |= SETMASK;
-            }
-        }
-        assert(!bigDone[ss]);
-
-        {
-            for (j = 0; j <= 255; j++) {
-                copyStart[j] =  ftab[(j << 8) + ss]     & CLEARMASK;
-                copyEnd  [j] = (ftab[(j << 8) + ss + 1] & CLEARMASK) - 1;
-            }
-
-            if (ss==0) {
-                k=Text_size-1;
-                c1 = Text[k];
-                if (!bigDone[c1])
-                    Sa[ copyStart[c1]++ ] = k;
-            }
-            for (j = ftab[ss << 8] & CLEARMASK; j < copyStart[ss]; j++) {
-                k = Sa[j]-1; if (k < 0) continue;
-                c1 = Text[k];
-                if (!bigDone[c1])
-                    Sa[ copyStart[c1]++ ] = k;
-            }
-            for (j = (ftab[(ss+1) << 8] & CLEARMASK) - 1; j > copyEnd[ss]; j--) {
-                k = Sa[j]-1; if (k < 0) continue;
-                c1 = Text[k];
-                if (!bigDone[c1])
-                    Sa[ copyEnd[c1]-- ] = k;
-            }
-        }
-        assert(copyStart[ss] - 1 == copyEnd[ss]);
-        for (j = 0; j <= 255; j++) ftab[(j << 8) + ss] |= SETMASK;
-        bigDone[ss] = TRUE;
-    }
-    if (_ds_Verbose) {
-        fprintf(stderr, "\t %d pointers, %d sorted, %d scanned\n",
-                Text_size, numQSorted, Text_size - numQSorted);
-        fprintf(stderr, "\t %d calls to helped_sort\n",Calls_helped_sort);
-        fprintf(stderr, "\t %d calls to anchor_sort (forward)\n",
-                Calls_anchor_sort_forw);
-        fprintf(stderr, "\t %d calls to anchor_sort (backward)\n",
-                Calls_anchor_sort_backw);
-        fprintf(stderr, "\t %d calls to pseudo_anchor_sort (forward)\n",
-                Calls_pseudo_anchor_sort_forw);
-        fprintf(stderr, "\t %d calls to deep_sort\n",Calls_deep_sort);
-    }
-
-    free(Anchor_offset);
-    free(Anchor_rank);
-}
-
-
-
-/* ****************************************************************
-   compute running =(sorting) order for big buckets: start with
-   the least full and proceed to the largest one.
-   The sorting is done using shellsort
-   **************************************************************** */
-
-void calc_running_order(void)
-{
-    int32_t i, j;
-    for (i = 0; i <= 255; i++) runningOrder[i] = i;
-
-    {
-        int32_t vv;
-        int32_t h = 1;
-        do h = 3 * h + 1; while (h <= 256);
-        do {
-            h = h / 3;
-            for (i = h; i <= 255; i++) {
-                vv = runningOrder[i];
-                j = i;
-                while (BIGFREQ(runningOrder[j-h]) > BIGFREQ(vv)) {
-                    runningOrder[j] = runningOrder[j-h];
-                    j = j - h;
-                    if (j <= (h - 1)) goto zero;
-                }
-zero:
-                runningOrder[j] = vv;
-            }
-        } while (h != 1);
-    }
-}
-
-
-uint8_t* transform_bwt(uint8_t* input,int32_t n,uint8_t* out,int32_t* I)
-{
-    int32_t overshoot;
-    int32_t* sa;
-    int32_t i,j;
-
-    overshoot=init_ds_ssort(500,2000);
-
-    uint8_t* txt = safe_malloc((n+overshoot)*sizeof(uint8_t));
-
-    memcpy(txt,input,n);
-
-    Text = txt;
-
-    Upper_text_limit = Text + n;
-    Text_size = n;
-
-    sa = safe_malloc(n*sizeof(int32_t));
-
-    Sa = sa;
-
-    ds_ssort(txt,sa,n);
-
-    j = 1;
-    out[0] = txt[n-1];
-    for (i=0; i<n; i++) {
-        if (sa[i]!=0) {
-            out[j] = txt[sa[i]-1];
-            j++;
-        } else *I = i;
-    }
-
-    free(sa);
-    free(txt);
-
-    return out;
-}
-
-
-
-
-
+/*
+ * File:   libbwt.c
+ * Author: Matthias Petri
+ *
+ *  BWT implementation based on
+ *  "An efficient method for in memory construction of suffix arrays"
+ *  by Itoh, Hideo and Tanaka, H.
+ */
+/* >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+   ds.c
+   deep-shallow sorting algorithm. these routines are taken mainly by
+   Seward's d_copyEQ_u12.c
+   Buckets are sorted one at a time; when  bucket Y is completely sorted
+   (except for YY) "pointer copying" is used to sort small buckets of
+   the form XY, X=A..Z
+   >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
+
+#include "libutil.h"
+#include "libbwt.h"
+#include "libsais.h"
+#include "libdna.h"
+#include "libsmall.h"
+#include "librank.h"
+/* *******************************************************************
+   globals.c
+   Ver 1.0   14-oct-02
+   This file contains the parameters which can be defined by the
+   user + some relate procedures. Parameters and sorting state are
+   kept in a ds_ctx_t so several sorts can run at the same time
+   ******************************************************************* */
+#include <assert.h>
+#include <limits.h>
+
+/* ---- sorting parameters and state live in ds_ctx_t (see libbwt.h) ----- */
+int check_ds_params(ds_ctx_t* ctx);
+void set_ds_params(ds_ctx_t* ctx);
+int compute_overshoot(ds_ctx_t* ctx);
+
+
+void deep_sort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth);
+
+
+
+
+#define Get_small_bucket(pos) ((ctx->Text[pos]<<8) + ctx->Text[pos+1])
+
+
+
+void general_anchor_sort(ds_ctx_t* ctx,int32_t* a,int32_t n,int32_t pos,int32_t rank,int32_t off);
+
+void pseudo_anchor_sort(ds_ctx_t* ctx,int32_t* a, int32_t n,int32_t pseudo_an,int32_t offset);
+int32_t split_group(ds_ctx_t* ctx,int32_t* a, int n, int,int,int32_t,int*);
+void update_anchors(ds_ctx_t* ctx,int32_t* a, int32_t n);
+void pseudo_or_deep_sort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth);
+
+
+
+
+
+
+
+
+
+
+void int_sort(int32_t* a, int32_t n);
+node* find_companion(ds_ctx_t* ctx,node* head, uint8_t* s);
+void insert_suffix(ds_ctx_t* ctx,node* h, int32_t suf, int n, uint8_t mmchar);
+void traverse_trie(ds_ctx_t* ctx,node* h);
+int32_t compare_suffixes(ds_ctx_t* ctx,int32_t suf1, int32_t suf2, int32_t depth);
+void free_node_mem(ds_ctx_t* ctx);
+node* get_leaf(node* head);
+
+
+
+/* ******************************************************************
+   sort the integers a[0] ... a[n-1] in increasing order. used for
+   the suffix offsets of blind_ssort and general_anchor_sort instead
+   of qsort(), which pays an indirect call per comparison
+   ****************************************************************** */
+void int_sort(int32_t* a, int32_t n)
+{
+    int32_t i, j, p, t;
+
+    while (n > 16) {
+        /* median of three to a[0], then partition a[1..n-1] */
+        i = n/2; j = n-1;
+        if (a[i] < a[0]) { t = a[i]; a[i] = a[0]; a[0] = t; }
+        if (a[j] < a[0]) { t = a[j]; a[j] = a[0]; a[0] = t; }
+        if (a[j] < a[i]) { t = a[j]; a[j] = a[i]; a[i] = t; }
+        t = a[i]; a[i] = a[0]; a[0] = t;
+        p = a[0];
+        i = 0; j = n;
+        while (1) {
+            do i++; while (i < n && a[i] < p);
+            do j--; while (a[j] > p);
+            if (i >= j) break;
+            t = a[i]; a[i] = a[j]; a[j] = t;
+        }
+        a[0] = a[j]; a[j] = p;
+        /* recurse on the smaller side */
+        if (j < n-j-1) {
+            int_sort(a,j);
+            a += j+1; n -= j+1;
+        } else {
+            int_sort(a+j+1,n-j-1);
+            n = j;
+        }
+    }
+    for (i = 1; i < n; i++) {
+        t = a[i];
+        for (j = i; j > 0 && a[j-1] > t; j--) a[j] = a[j-1];
+        a[j] = t;
+    }
+}
+
+/* is x one of the sorted integers a[0] ... a[n-1] */
+int int_find(const int32_t* a, int32_t n, int32_t x)
+{
+    int32_t lo = 0, hi = n;
+
+    while (lo < hi) {
+        int32_t mid = lo + (hi-lo)/2;
+        if (a[mid] < x) lo = mid+1;
+        else hi = mid;
+    }
+    return lo < n && a[lo] == x;
+}
+
+
+/* ****************************************************************
+   routine for deep-sorting the suffixes a[0] ... a[n-1]
+   knowing that they have a common prefix of length "depth"
+  **************************************************************** */
+void blind_ssort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth)
+{
+    int32_t i,j,aj,lcp;
+    node nh, *root, *h;
+
+
+    int_sort(a,n);
+    for (i=0, j=n-1; i<j; i++, j--) {
+        aj = a[i]; a[i] = a[j]; a[j] = aj;
+    }
+
+
+    for (j=0; j<n; j++)
+        if (a[j]+depth < ctx->Text_size)
+            break;
+    if (j>=n-1) return;
+
+
+    if (ctx->Stack_cap < n) {
+        ctx->Stack_cap = MAX(n,2*ctx->Stack_cap);
+        ctx->Stack = (node**) safe_realloc(ctx->Stack,ctx->Stack_cap*sizeof(node*));
+    }
+
+
+    nh.skip = -1;   nh.right = NULL; nh.down = (void*) a[j];
+    root = &nh;
+
+
+    for (i=j+1; i<n; i++) {
+        h=find_companion(ctx,root, ctx->Text+a[i]);
+        assert(h->skip==-1);
+        assert(ctx->Stack_size<=i-j);
+        aj=(int32_t) h->down;
+        assert(aj>a[i]);
+        lcp = compare_suffixes(ctx,aj,a[i],depth);
+        insert_suffix(ctx,root, a[i], lcp, ctx->Text[aj+lcp]);
+    }
+
+
+    ctx->Aux=a;  ctx->Aux_written = j;
+    traverse_trie(ctx,root);
+    assert(ctx->Aux_written==n);
+
+    free_node_mem(ctx);
+}
+
+/* ***********************************************************************
+   this function traverses the trie rooted at head following the string s.
+   Returns the leaf "corresponding" to the string s
+   *********************************************************************** */
+node* find_companion(ds_ctx_t* ctx,node* head, uint8_t* s)
+{
+    uint8_t c;
+    node* p;
+    int t;
+
+    ctx->Stack_size = 0;
+    while (head->skip >= 0) {
+        ctx->Stack[ctx->Stack_size++] = head;
+        t = head->skip;
+        if (s+t>=ctx->Upper_text_limit)
+            return get_leaf(head);
+        c = s[t]; p = head->down;
+repeat:
+        if (c==p->key) {
+            head = p;
+            continue;
+        } else if (c<p->key)
+            return get_leaf(head);
+        if ((p=(p->right))==NULL)
+            return get_leaf(head);
+        goto repeat;
+    }
+    ctx->Stack[ctx->Stack_size++] = head;
+    return head;
+}
+
+
+
+
+node* get_leaf(node* head)
+{
+    assert(head->skip>=0);
+
+    do {
+        head = head->down;
+    } while (head->skip>=0);
+    return head;
+}
+
+
+
+node* new_node__blind_ssort(ds_ctx_t* ctx)
+{
+    node_chunk_t* c, *next;
+
+    c = ctx->Node_cur;
+    if (c == NULL || ctx->Node_used == c->size) {
+        /* the next chunk, which an earlier sort may have allocated */
+        next = (c == NULL) ? ctx->Node_chunks : c->next;
+        if (next == NULL) {
+            next = (node_chunk_t*) safe_malloc(sizeof(node_chunk_t));
+            next->size = (c == NULL) ? BUFSIZE : MIN(2*c->size,BUFSIZE_MAX);
+            next->nodes = (node*) safe_malloc(next->size*sizeof(node));
+            if (c == NULL) ctx->Node_chunks = next;
+            else c->next = next;
+        }
+        ctx->Node_cur = next;
+        ctx->Node_used = 0;
+    }
+    return &ctx->Node_cur->nodes[ctx->Node_used++];
+}
+
+
+/* *****************************************************
+   insert a suffix in the trie rooted at *p.
+   we know that the trie already contains a string
+   which share the first n chars with suf
+   ***************************************************** */
+void insert_suffix(ds_ctx_t* ctx,node* h, int32_t suf, int n, uint8_t mmchar)
+{
+    node* new_node__blind_ssort(ds_ctx_t* ctx);
+    int32_t t;
+    uint8_t c, *s;
+    node* p, **pp;
+
+    s = ctx->Text + suf;
+
+#if 0
+
+    while ((t=h->skip) < n) {
+        if (t < 0) break;
+        c=s[t];  p=h->down;
+
+repeat:
+        if (c==p->key) {
+            h = p;
+            continue;
+        }
+        if (c>p->key && p->right!=NULL) {
+            p=p->right;
+            goto repeat;
+        }
+
+        fprintf(stderr,"Error in blind_sort (insert_string)\n");
+        exit(1);
+    }
+#else
+    for (t=0; t<ctx->Stack_size; t++) {
+        h=ctx->Stack[t];
+        if (h->skip<0 || h->skip>=n) break;
+    }
+#endif
+
+    assert(s[n]!=mmchar || h->skip==-1 || h->skip==n);
+
+
+    if (h->skip!=n) {
+        p = new_node__blind_ssort(ctx);
+        p->key = mmchar;
+        p->skip = h->skip;
+        p->down = h->down;
+        p->right = NULL;
+        h->skip = n;
+        h->down = p;
+    }
+    assert(h->skip==n);
+
+
+    c=s[n]; pp = &(h->down);
+    while ((*pp)!=NULL) {
+        if ((*pp)->key>=c)
+            break;
+        pp = &((*pp)->right);
+    }
+
+    p = new_node__blind_ssort(ctx);
+    p->skip = -1;
+    p->key = c;
+    p->right = *pp; *pp = p;
+    p->down = (void*) suf;
+    return;
+}
+
+/* ************************************************************
+   this procedures traverse the trie in depth first order
+   so that the suffixes (stored in the leaf) are recovered
+   in lexicographic order
+   ************************************************************ */
+void traverse_trie(ds_ctx_t* ctx,node* h)
+{
+    node* p, *nextp;
+
+    if (h->skip<0)
+        ctx->Aux[ctx->Aux_written++] = (int32_t) h->down;
+    else {
+        p = h->down;
+        assert(p!=NULL);
+        do {
+            nextp = p->right;
+            if (nextp!=NULL) {
+                assert(nextp->key>=p->key);
+
+
+                if (nextp->key==p->key) {
+                    traverse_trie(ctx,nextp);
+                    traverse_trie(ctx,p);
+                    p = nextp->right;
+                    continue;
+                }
+            }
+            traverse_trie(ctx,p);
+            p=nextp;
+        } while (p!=NULL);
+    }
+}
+
+
+
+/* ***********************************************************************
+   Function to compute the lcp of two strings originating from the *b1 and *b2
+   the parameter is the length of s1 (which is shortest than s2)
+   if s1 is a prefix of s2 we return the length of s1 -1
+   The size of the unrolled loop must be at most equal to the costant
+   Cmp_overshoot defined in common.h
+   the function return the result of the comparison (+ or -) and writes
+   in Cmp_done the number of comparisons done
+   *********************************************************************** */
+static
+int32_t get_lcp_unrolled(uint8_t* b1, uint8_t* b2, int32_t cmp_limit)
+{
+    int32_t cmp2do;
+    uint8_t c1, c2;
+    assert(b1 != b2);
+
+
+
+    cmp2do = cmp_limit;
+    do {
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  1; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  2; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  3; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  4; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  5; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  6; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  7; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  8; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -=  9; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 10; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 11; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 12; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 13; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 14; break;
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            cmp2do -= 15; break;
+        }
+        b1++; b2++;
+
+        cmp2do -= 16;
+    } while (cmp2do>0);
+
+
+    if (cmp_limit - cmp2do < cmp_limit)
+        return cmp_limit-cmp2do;
+
+    return cmp_limit-1;
+}
+
+
+
+/* ************************************************************************
+   this function returns the lcp between suf1 and suf2 (that is returns n
+   such that suf1[n]!=suf2[n] but suf1[i]==suf2[i] for i=0..n-1
+   However, it is possible that suf1 is a prefix of suf2 (not vice-versa
+   because of the initial sorting of suffixes in order of descreasing length)
+   in this case the function returns n=length(suf1)-1. So in this case
+   suf1[n]==suf2[n] (and suf1[n+1] does not exists).
+   ************************************************************************ */
+int32_t compare_suffixes(ds_ctx_t* ctx,int32_t suf1, int32_t suf2, int32_t depth)
+{
+    int32_t get_lcp_unrolled(uint8_t*, uint8_t*, int32_t);
+    int limit;
+    uint8_t* s1, *s2;
+
+    assert(suf1>suf2);
+    s1  = ctx->Text + depth +suf1;
+    s2  = ctx->Text + depth +suf2;
+    limit = ctx->Text_size - suf1 - depth;
+#ifdef LCP_HAVE_SIMD
+    if (ctx->Simd == LCP_AVX2) return depth + get_lcp_avx2(s1 ,s2, limit);
+    if (ctx->Simd == LCP_SSE2) return depth + get_lcp_sse2(s1 ,s2, limit);
+#endif
+    return depth + get_lcp_unrolled(s1 ,s2, limit);
+}
+
+
+
+
+
+
+/* rewind the node arena, the chunks are kept for the next sort */
+void free_node_mem(ds_ctx_t* ctx)
+{
+    ctx->Node_cur = NULL;
+    ctx->Node_used = 0;
+}
+
+
+
+
+
+
+
+
+
+
+
+/* ***********************************************************************
+   Function to compare two strings originating from the *b1 and *b2
+   The size of the unrolled loop must be at most equal to the costant
+   Cmp_overshoot defined in common.h
+   the function return the result of the comparison (+ or -) and writes
+   in Cmp_done the number of successfull comparisons done
+   *********************************************************************** */
+int32_t cmp_unrolled_lcp(ds_ctx_t* ctx,uint8_t* b1, uint8_t* b2)
+{
+
+    uint8_t c1, c2;
+    assert(b1 != b2);
+#ifdef LCP_HAVE_SIMD
+    if (ctx->Simd == LCP_AVX2)
+        return cmp_lcp_avx2(b1,b2,ctx->Upper_text_limit,&ctx->Cmp_done);
+    if (ctx->Simd == LCP_SSE2)
+        return cmp_lcp_sse2(b1,b2,ctx->Upper_text_limit,&ctx->Cmp_done);
+#endif
+    ctx->Cmp_done=0;
+
+
+
+    do {
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  1; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  2; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  3; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  4; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  5; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  6; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  7; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  8; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done +=  9; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 10; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 11; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 12; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 13; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 14; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_done += 15; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        ctx->Cmp_done += 16;
+
+    } while (b1<ctx->Upper_text_limit && b2<ctx->Upper_text_limit);
+
+
+    return b2 - b1;
+}
+
+/* **************************************************************
+   ternary quicksort (seward-like) with lcp information
+   ************************************************************** */
+#define STACK_SIZE 100
+#define Swap(i,j) {tmp=a[i]; a[i]=a[j]; a[j]=tmp;}
+#define Pushd(x,y,z) {stack_lo[sp]=x; stack_hi[sp]=y; stack_d[sp]=z; sp++;}
+#define Popd(x,y,z)  {sp--; x=stack_lo[sp]; y=stack_hi[sp]; z=stack_d[sp];}
+void qs_unrolled_lcp(ds_ctx_t* ctx,int32_t* a, int n, int depth, int blind_limit)
+{
+    void blind_ssort(ds_ctx_t* ctx,int32_t *a, int32_t n, int32_t depth);
+    int32_t cmp_unrolled_lcp(ds_ctx_t* ctx,uint8_t *b1, uint8_t *b2);
+    uint8_t* text_depth, *text_pos_pivot;
+    int32_t stack_lo[STACK_SIZE];
+    int32_t stack_hi[STACK_SIZE];
+    int32_t stack_d[STACK_SIZE];
+    int32_t sp,r,r3,med,tmp;
+    int32_t i, j, lo, hi,ris,lcp_lo,lcp_hi;
+
+
+    r=sp=0;
+    Pushd(0,n-1,depth);
+
+
+    while (sp > 0) {
+        assert(sp < STACK_SIZE);
+        Popd(lo,hi,depth);
+        text_depth = ctx->Text+depth;
+
+
+        if (hi-lo<blind_limit) {
+            blind_ssort(ctx,a+lo,hi-lo+1,depth);
+            continue;
+        }
+
+        /* Random partitioning. Guidance for the magic constants
+           7621 and 32768 is taken from Sedgewick's algorithms
+           book, chapter 35.
+        */
+        r = ((r * 7621) + 1) % 32768;
+        r3 = r % 3;
+        if (r3 == 0) med = lo; else if (r3 == 1) med = (lo+hi)>>1; else
+            med = hi;
+
+
+        Swap(med,hi);
+        text_pos_pivot=text_depth+a[hi];
+        i=lo-1; j=hi;
+        lcp_lo=lcp_hi=INT_MAX;
+        while (1) {
+            while (++i<hi) {
+                ris=cmp_unrolled_lcp(ctx,text_depth+a[i], text_pos_pivot);
+                if (ris>0) {
+                    if (ctx->Cmp_done < lcp_hi) lcp_hi=ctx->Cmp_done; break;
+                } else if (ctx->Cmp_done < lcp_lo) lcp_lo=ctx->Cmp_done;
+            }
+            while (--j>lo) {
+                ris=cmp_unrolled_lcp(ctx,text_depth+a[j], text_pos_pivot);
+                if (ris<0) {
+                    if (ctx->Cmp_done < lcp_lo) lcp_lo=ctx->Cmp_done;
+                    break;
+                } else if (ctx->Cmp_done < lcp_hi) lcp_hi=ctx->Cmp_done;
+            }
+            if (i >= j) break;
+            Swap(i,j);
+        }
+        Swap(i,hi);
+
+
+        assert(lcp_lo<INT_MAX || i==lo);
+        assert(lcp_hi<INT_MAX || i==hi);
+
+
+        if (i-lo < hi-i) {
+            Pushd(i+1,hi,depth+lcp_hi);
+            if (i-lo>1) Pushd(lo,i-1,depth+lcp_lo);
+        } else {
+            Pushd(lo,i-1,depth+lcp_lo);
+            if (hi-i>1) Pushd(i+1,hi,depth+lcp_hi);
+        }
+    }
+}
+
+
+
+/* ****************************************************************
+   routine for deep-sorting the suffixes a[0] ... a[n-1]
+   knowing that they have a common prefix of length "depth"
+  **************************************************************** */
+void deep_sort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth)
+{
+    void blind_ssort(ds_ctx_t* ctx,int32_t *a, int32_t n, int32_t depth);
+    int blind_limit;
+
+    ctx->Calls_deep_sort++;
+    assert(n>1);
+
+    blind_limit=ctx->Text_size/ctx->Blind_sort_ratio;
+    if (n<=blind_limit)
+        blind_ssort(ctx,a,n,depth);
+    else
+        qs_unrolled_lcp(ctx,a,n,depth,blind_limit);
+}
+
+
+
+/* *****************************************************************
+   This procedure sort the strings a[0] ... a[n-1] with the help of an
+   anchor. The real sorting is done by the procedure
+   anchor_sort(). Here we choose the anchor.  The parameter depth is
+   the number of chars that a[0] ... a[n-1] are known to have in
+   common (thus a direct comparison among a[i] and a[j] should start
+   from position depth) Note that a[] is a subsection of the sa therefore
+   a[0] ... a[n-1] are starting position of suffixes
+   For every a[i] we look at the anchor a[i]/Anchor_dist and the one
+   after that. This justifies the definition of Anchor_num (the size of
+   Anchor_ofset[] and Anchor_rank[] defined in ds_sort()) as
+     Anchor_num = 2 + (n-1)/Anchor_dist
+   ***************************************************************** */
+void helped_sort(ds_ctx_t* ctx,int32_t* a, int n, int depth)
+{
+    int32_t i, curr_sb, diff, toffset, aoffset;
+    int32_t text_pos, anchor_pos, anchor, anchor_rank;
+    int32_t min_forw_offset, min_forw_offset_buc, max_back_offset;
+    int32_t best_forw_anchor, best_forw_anchor_buc, best_back_anchor;
+    int32_t forw_anchor_index, forw_anchor_index_buc, back_anchor_index;
+
+    ctx->Calls_helped_sort++;
+    if (n==1) goto done_sorting;
+
+
+    if (ctx->Anchor_dist==0) {
+        pseudo_or_deep_sort(ctx,a, n, depth);
+        return;
+    }
+
+
+    curr_sb = Get_small_bucket(a[0]);
+
+
+    min_forw_offset = min_forw_offset_buc = INT_MAX;
+    max_back_offset = INT_MIN;
+    best_forw_anchor = best_forw_anchor_buc = best_back_anchor = -1;
+    forw_anchor_index = forw_anchor_index_buc = back_anchor_index = -1;
+
+    for (i=0; i<n; i++) {
+        text_pos = a[i];
+
+        anchor = text_pos/ctx->Anchor_dist;
+        toffset = text_pos % ctx->Anchor_dist;
+        aoffset = ctx->Anchor_offset[anchor];
+        if (aoffset<ctx->Anchor_dist) {
+            diff = aoffset - toffset;
+            assert(diff!=0);
+            if (diff>0) {
+                if (curr_sb!=Get_small_bucket(text_pos+diff)) {
+                    if (diff<min_forw_offset) {
+                        min_forw_offset = diff;
+                        best_forw_anchor = anchor;
+                        forw_anchor_index = i;
+                    }
+                } else {
+                    if (diff<min_forw_offset_buc) {
+                        min_forw_offset_buc = diff;
+                        best_forw_anchor_buc = anchor;
+                        forw_anchor_index_buc = i;
+                    }
+                }
+            } else {
+                if (diff>max_back_offset) {
+                    max_back_offset = diff;
+                    best_back_anchor = anchor;
+                    back_anchor_index = i;
+                }
+
+                aoffset = ctx->Anchor_offset[++anchor];
+                if (aoffset<ctx->Anchor_dist) {
+                    diff = ctx->Anchor_dist + aoffset - toffset;
+                    assert(diff>0);
+                    if (curr_sb!=Get_small_bucket(text_pos+diff)) {
+                        if (diff<min_forw_offset) {
+                            min_forw_offset = diff;
+                            best_forw_anchor = anchor;
+                            forw_anchor_index = i;
+                        }
+                    } else {
+                        if (diff<min_forw_offset_buc) {
+                            min_forw_offset_buc = diff;
+                            best_forw_anchor_buc = anchor;
+                            forw_anchor_index_buc = i;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (best_forw_anchor>=0 && min_forw_offset<depth-1) {
+        ctx->Calls_anchor_sort_forw++;
+        assert(min_forw_offset<2*ctx->Anchor_dist);
+        anchor_pos = a[forw_anchor_index] + min_forw_offset;
+        anchor_rank = ctx->Anchor_rank[best_forw_anchor];
+        assert(ctx->Sa[anchor_rank]==anchor_pos);
+        general_anchor_sort(ctx,a,n,anchor_pos,anchor_rank,min_forw_offset);
+        goto done_sorting;
+    }
+
+    if (best_back_anchor>=0) {
+        uint8_t* T0, *Ti; int j;
+
+        assert(max_back_offset>-ctx->Anchor_dist && max_back_offset<0);
+
+        for (i=0; i<n; i++) {
+            if (a[i]+max_back_offset<0)
+                goto fail;
+        }
+
+        T0 = ctx->Text + a[0];
+        for (i=1; i<n; i++) {
+            Ti = ctx->Text + a[i];
+            for (j=max_back_offset; j<= -1; j++)
+                if (T0[j]!=Ti[j]) goto fail;
+        }
+
+        ctx->Calls_anchor_sort_backw++;
+        anchor_pos = a[back_anchor_index] + max_back_offset;
+        anchor_rank = ctx->Anchor_rank[best_back_anchor];
+        assert(ctx->Sa[anchor_rank]==anchor_pos);
+        general_anchor_sort(ctx,a,n,anchor_pos,anchor_rank,max_back_offset);
+        goto done_sorting;
+    }
+fail:
+
+    if (best_forw_anchor_buc>=0 && min_forw_offset_buc<depth-1) {
+        int equal,lower,upper;
+
+        assert(min_forw_offset_buc<2*ctx->Anchor_dist);
+        anchor_pos = a[forw_anchor_index_buc] + min_forw_offset_buc;
+        anchor_rank = ctx->Anchor_rank[best_forw_anchor_buc];
+        assert(ctx->Sa[anchor_rank]==anchor_pos);
+
+
+        equal=split_group(ctx,a,n,depth,min_forw_offset_buc,
+                          forw_anchor_index_buc,&lower);
+        if (equal==n) {
+            ctx->Calls_anchor_sort_forw++;
+            general_anchor_sort(ctx,a,n,anchor_pos,anchor_rank,min_forw_offset_buc);
+        } else {
+
+            upper = n-equal-lower;
+            assert(upper>=0);
+
+
+            ctx->Calls_anchor_sort_forw++;
+            if (equal>1)
+                general_anchor_sort(ctx,a+lower,equal,anchor_pos,anchor_rank,
+                                    min_forw_offset_buc);
+
+
+            if (lower>1) pseudo_or_deep_sort(ctx,a,lower,depth);
+            if (upper>1) pseudo_or_deep_sort(ctx,a+lower+equal,upper,depth);
+        }
+        goto done_sorting;
+    }
+
+
+
+
+
+    pseudo_or_deep_sort(ctx,a, n, depth);
+done_sorting:
+
+    if (ctx->Anchor_dist>0) update_anchors(ctx,a, n);
+}
+
+
+
+/* *******************************************************************
+   try pseudo_anchor sort or deep_sort
+   ******************************************************************** */
+void pseudo_or_deep_sort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth)
+{
+
+    int32_t offset, text_pos, sb, pseudo_anchor_pos, max_offset, size;
+
+
+    if (ctx->Max_pseudo_anchor_offset>0) {
+
+        max_offset = MIN(depth-1,ctx->Max_pseudo_anchor_offset);
+        text_pos = a[0];
+        for (offset=1; offset<max_offset; offset++) {
+            pseudo_anchor_pos = text_pos+offset;
+            sb = Get_small_bucket(pseudo_anchor_pos);
+
+            if (IS_SORTED_BUCKET(sb)) {
+                size=BUCKET_SIZE(sb);
+                if (size>ctx->B2g_ratio*n) continue;
+
+                pseudo_anchor_sort(ctx,a,n,pseudo_anchor_pos,offset);
+                ctx->Calls_pseudo_anchor_sort_forw++;
+                return;
+            }
+        }
+    }
+    deep_sort(ctx,a,n,depth);
+}
+
+/* ********************************************************************
+   this routine sorts the suffixes a[0] ... a[n-1] using the fact that
+   in their common prefix, after offset characters, there is a
+   suffix which is in an already sorted bucket. This suffix is called
+   a pseudo anchor since it is used essentially as an anchor, but
+   it is not in an anchor position (=position multiple of Anchor_dist)
+   ******************************************************************** */
+void pseudo_anchor_sort(ds_ctx_t* ctx,int32_t* a,int32_t n,int32_t pseudo_anchor_pos, int32_t offset)
+{
+    int32_t get_rank(ds_ctx_t* ctx,int32_t);
+    int32_t get_rank_update_anchors(ds_ctx_t* ctx,int32_t);
+    int32_t pseudo_anchor_rank;
+
+
+    if (ctx->Update_anchor_ranks!=0 && ctx->Anchor_dist>0)
+        pseudo_anchor_rank = get_rank_update_anchors(ctx,pseudo_anchor_pos);
+    else
+        pseudo_anchor_rank = get_rank(ctx,pseudo_anchor_pos);
+
+    assert(ctx->Sa[pseudo_anchor_rank]==pseudo_anchor_pos);
+
+    general_anchor_sort(ctx,a,n,pseudo_anchor_pos,pseudo_anchor_rank,offset);
+}
+
+
+/* ********************************************************************
+   This routines sorts a[0] ... a[n-1] using the fact that
+   in their common prefix, after offset characters, there is a
+   suffix whose rank is known. In this routine we call this suffix anchor
+   (and we denote its position and rank with anchor_pos and anchor_rank
+   respectively) but it is not necessarily an anchor (=does not necessarily
+   starts at position multiple of Anchor_dist) since this function is
+   called by pseudo_anchor_sort().
+   The routine works by scanning the suffixes before and after the anchor
+   in order to find those which are suffixes of a[0] ... a[n-1].
+   The ones found before the anchor are collected from the end of
+   Anchor_buf[] and the ones after it from the front, so the ordering
+   of a[0] ... a[n-1] is read off the buffer afterwards. The bucket of
+   the anchor is only read, so several sorts can use it at once.
+   ******************************************************************** */
+void general_anchor_sort(ds_ctx_t* ctx,int32_t* a, int32_t n,
+                         int32_t anchor_pos, int32_t anchor_rank, int32_t offset)
+{
+    int int_find(const int32_t* a, int32_t n, int32_t x);
+    int32_t sb, lo, hi;
+    int32_t curr_lo, curr_hi, to_be_found, nlo, nhi;
+    int32_t item, *buf;
+
+    assert(ctx->Sa[anchor_rank]==anchor_pos);
+    /* ---------- get bucket of anchor ---------- */
+    sb = Get_small_bucket(anchor_pos);
+    lo = BUCKET_FIRST(sb);
+    hi = BUCKET_LAST(sb);
+    assert(sb==Get_small_bucket(a[0]+offset));
+
+    int_sort(a,n);
+
+    if (ctx->Anchor_buf_size < n) {
+        ctx->Anchor_buf_size = MAX(n,2*ctx->Anchor_buf_size);
+        ctx->Anchor_buf = (int32_t*) safe_realloc(ctx->Anchor_buf,
+                          ctx->Anchor_buf_size*sizeof(int32_t));
+    }
+    buf = ctx->Anchor_buf;
+
+    curr_hi = curr_lo = anchor_rank;
+
+
+#if DEBUG
+    item = anchor_pos-offset;
+    assert(int_find(a,n,item));
+#endif
+
+    nlo = nhi = 0;
+    for (to_be_found=n-1; to_be_found>0;) {
+
+        assert(curr_lo > lo || curr_hi < hi);
+        while (curr_lo > lo) {
+            item = ctx->Sa[--curr_lo]-offset;
+            if (int_find(a,n,item))	{
+                buf[n-1-nlo++] = item;
+                to_be_found--;
+            } else	break;
+        }
+        while (curr_hi < hi) {
+            item = ctx->Sa[++curr_hi]-offset;
+            if (int_find(a,n,item))	{
+                buf[nhi++] = item;
+                to_be_found--;
+            } else      break;
+        }
+    }
+    assert(nlo+nhi==n-1);
+
+    memcpy(a,buf+n-nlo,nlo*sizeof(int32_t));
+    a[nlo] = anchor_pos-offset;
+    memcpy(a+nlo+1,buf,nhi*sizeof(int32_t));
+}
+
+/* ********************************************************************
+   store the rank of the suffix at anchor*Anchor_dist+offset. while the
+   small buckets of a big bucket are sorted in parallel the update is
+   only logged and applied by ds_ssort once all of them are done, so
+   a sort never finds an anchor in a bucket which is still being sorted
+   ******************************************************************** */
+static void set_anchor(ds_ctx_t* ctx,int32_t anchor,int32_t offset,int32_t rank)
+{
+    if (!ctx->Anchor_defer) {
+        ctx->Anchor_offset[anchor] = offset;
+        ctx->Anchor_rank[anchor] = rank;
+        return;
+    }
+    if (ctx->Anchor_log_num+3 > ctx->Anchor_log_size) {
+        ctx->Anchor_log_size = MAX(1024,2*ctx->Anchor_log_size);
+        ctx->Anchor_log = (int32_t*) safe_realloc(ctx->Anchor_log,
+                          ctx->Anchor_log_size*sizeof(int32_t));
+    }
+    ctx->Anchor_log[ctx->Anchor_log_num++] = anchor;
+    ctx->Anchor_log[ctx->Anchor_log_num++] = offset;
+    ctx->Anchor_log[ctx->Anchor_log_num++] = rank;
+}
+
+/* ********************************************************************
+   compute the rank of the suffix starting at pos.
+   It is required that the suffix is in an already sorted bucket
+   ******************************************************************** */
+int32_t get_rank(ds_ctx_t* ctx,int32_t pos)
+{
+    int32_t sb, lo, hi, j;
+
+    sb = Get_small_bucket(pos);
+    if (!IS_SORTED_BUCKET(sb)) {
+        fprintf(stderr,"Illegal call to get_rank! (get_rank1)\n");
+        exit(1);
+    }
+    lo = BUCKET_FIRST(sb);
+    hi = BUCKET_LAST(sb);
+    for (j=lo; j<=hi; j++)
+        if (ctx->Sa[j]==pos) return j;
+    fprintf(stderr,"Illegal call to get_rank! (get_rank2)\n");
+    exit(1);
+    return 1;
+}
+
+/* ********************************************************************
+   compute the rank of the suffix starting at pos. At the same time
+   check if the rank of the suffixes in the bucket containing pos
+   can be used to update some entries in Anchor_offset[] and Anchor_rank[]
+   It is required that the suffix is in an already sorted bucket
+   ******************************************************************** */
+int32_t get_rank_update_anchors(ds_ctx_t* ctx,int32_t pos)
+{
+    int32_t get_rank(ds_ctx_t* ctx,int32_t pos);
+    int32_t sb, lo, hi, j, toffset, aoffset, anchor, rank;
+
+    assert(ctx->Anchor_dist>0);
+
+    sb = Get_small_bucket(pos);
+    if (!(IS_SORTED_BUCKET(sb))) {
+        fprintf(stderr,"Illegal call to get_rank! (get_rank_update_anchors)\n");
+        exit(1);
+    }
+
+    if (ctx->bucket_ranked[sb]) return get_rank(ctx,pos);
+
+    ctx->bucket_ranked[sb]=1;
+    rank = -1;
+    lo = BUCKET_FIRST(sb);
+    hi = BUCKET_LAST(sb);
+    for (j=lo; j<=hi; j++) {
+
+        toffset = ctx->Sa[j]%ctx->Anchor_dist;
+        anchor  = ctx->Sa[j]/ctx->Anchor_dist;
+        aoffset = ctx->Anchor_offset[anchor];
+        if (toffset<aoffset) set_anchor(ctx,anchor,toffset,j);
+
+        if (ctx->Sa[j]==pos) {
+            assert(rank==-1); rank=j;
+        }
+    }
+    assert(rank>=0);
+    return rank;
+}
+
+
+/* ****************************************************************
+   given a SORTED array of suffixes a[0] .. a[n-1]
+   updates Anchor_rank[] and Anchor_offset[]
+   **************************************************************** */
+void update_anchors(ds_ctx_t* ctx,int32_t* a, int32_t n)
+{
+    int32_t i,anchor,toffset,aoffset,text_pos;
+
+    assert(ctx->Anchor_dist>0);
+    for (i=0; i<n; i++) {
+        text_pos = a[i];
+
+        anchor = text_pos/ctx->Anchor_dist;
+        toffset = text_pos % ctx->Anchor_dist;
+        aoffset = ctx->Anchor_offset[anchor];
+        if (toffset<aoffset) {
+            assert(text_pos==anchor*ctx->Anchor_dist+toffset);
+            set_anchor(ctx,anchor,toffset,(a - ctx->Sa) + i);
+        }
+    }
+}
+
+
+
+/* *******************************************************************
+   This function takes as input an array a[0] .. a[n-1] of suffixes
+   which share the first "depth" chars. "pivot" in an index in 0..n-1
+   and offset and integer>0. The function splits a[0] .. a[n-1]
+   into 3 groups: first the suffixes which are smaller than a[pivot],
+   then those which are equal to a[pivot] and finally those which are
+   greater than a[pivot]. Here, smaller, equal, larger refer to
+   a lexicographic ordering limited to the first depth+offest chars
+   (since the first depth chars are equal we only look at the chars
+   in position depth, depth+1, ... depth+offset-1).
+   The function returns the number "num" of suffixes equal to a[pivot],
+   and stores in *first the first of these suffixes. So at the end
+   the smaller suffixes are in a[0] ... a[first-1],
+   the equal suffixes in a[first] ... a[first+num-1],
+   the larger suffixes in a[first+num] ... a[n-1]
+   The splitting is done using a modified mkq()
+   ******************************************************************* */
+#define swap2(a, b) { t = *(a); *(a) = *(b); *(b) = t; }
+#define ptr2char(i) (*(*(i) + text_depth))
+
+int32_t split_group(ds_ctx_t* ctx,int32_t* a, int n, int depth,int offset,int32_t pivot,int* first)
+{
+    void vecswap2(int32_t *a, int32_t *b, int n);
+    int r, partval;
+    int32_t* pa, *pb, *pc, *pd, *pa_old, *pd_old, pivot_pos, t;
+    uint8_t* text_depth,*text_limit;
+
+
+    pivot_pos = a[pivot];
+    text_depth = ctx->Text+depth;
+    text_limit = text_depth+offset;
+
+
+
+    pa = a; pd = a + n-1;
+
+    for (; pa!=pd && (text_depth<text_limit); text_depth++) {
+        assert(pa<pd);
+
+
+        partval = text_depth[pivot_pos];
+
+        pb = pa_old = pa;
+        pc = pd_old = pd;
+        for (;;) {
+            while (pb <= pc && (r = ptr2char(pb)-partval) <= 0) {
+                if (r == 0) {
+                    swap2(pa, pb);
+                    pa++;
+                }
+                pb++;
+            }
+            while (pb <= pc && (r = ptr2char(pc)-partval) >= 0) {
+                if (r == 0) {
+                    swap2(pc, pd);
+                    pd--;
+                }
+                pc--;
+            }
+            if (pb > pc) break;
+            swap2(pb, pc);
+            pb++;
+            pc--;
+        }
+        r = MIN(pa-pa_old, pb-pa); vecswap2(pa_old,  pb-r, r);
+        r = MIN(pd-pc, pd_old-pd); vecswap2(pb, pd_old+1-r, r);
+
+        pa = pa_old + (pb-pa);
+        pd = pd_old - (pd-pc);
+
+    }
+    *first=pa-a;
+    assert(pd-pa>=0);
+    return pd-pa+1;
+}
+
+
+
+
+
+
+/* >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
+   shallow.c
+   This is the multikey quicksort from bentley-sedgewick modified
+   so that it stops recursion when depth reaches  Shallow_limit
+   (that is when two or more suffixes have Shallow_limit chars in common).
+   >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+
+#define UNROLL 1
+
+
+
+
+
+void shallow_sort(ds_ctx_t* ctx,int32_t* a, int n, int shallow_limit)
+{
+
+    ctx->Shallow_limit = shallow_limit;
+    ctx->Shallow_text_limit = ctx->Text + shallow_limit;
+
+
+    switch (ctx->_ds_Word_size) {
+        case(1): shallow_mkq(ctx,a, n, ctx->Text+2); break;
+        case(2): shallow_mkq16(ctx,a, n, ctx->Text+2); break;
+        case(4): shallow_mkq32(ctx,a, n, ctx->Text+2); break;
+        case(8): shallow_mkq64(ctx,a, n, ctx->Text+2); break;
+        default:
+            fprintf(stderr,
+                    "Invalid word size for mkqs (%d) (shallow_sort)\n",ctx->_ds_Word_size);
+            exit(1);
+    }
+}
+
+
+/* =======================================================
+   auxiliary procedures and macro for bentley-sedgewick's
+   multikey quicksort
+   ======================================================= */
+void vecswap2(int32_t* a, int32_t* b, int n)
+{
+    while (n-- > 0) {
+        int32_t t = *a;
+        *a++ = *b;
+        *b++ = t;
+    }
+}
+
+#define swap2(a, b) { t = *(a); *(a) = *(b); *(b) = t; }
+#define ptr2char(i) (*(*(i) + text_depth))
+
+int32_t* med3func(int32_t* a, int32_t* b, int32_t* c, uint8_t* text_depth)
+{
+    int va, vb, vc;
+    if ((va=ptr2char(a)) == (vb=ptr2char(b)))
+        return a;
+    if ((vc=ptr2char(c)) == va || vc == vb)
+        return c;
+    return va < vb ?
+           (vb < vc ? b : (va < vc ? c : a))
+               : (vb > vc ? b : (va < vc ? a : c));
+}
+#define med3(a, b, c) med3func(a, b, c, text_depth)
+
+
+/* ********************************************************
+   recursive multikey quicksort from Bentley-Sedgewick
+   stops when text_depth reaches Shallow_depth_limit
+   that is when we have found that the current set of strings
+   have Shallow_limit chars in common
+   ******************************************************** */
+void shallow_mkq(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth)
+{
+    void vecswap2(int32_t *a, int32_t *b, int n);
+    int d, r, partval;
+    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t;
+    uint8_t* next_depth;
+
+
+    if (n < ctx->Mk_qs_thresh) {
+        shallow_inssort_lcp(ctx,a, n, text_depth);
+        return;
+    }
+
+
+repeat:
+    pl = a;
+    pm = a + (n/2);
+    pn = a + (n-1);
+    if (n > 30) {
+        d = (n/8);
+        pl = med3(pl, pl+d, pl+2*d);
+        pm = med3(pm-d, pm, pm+d);
+        pn = med3(pn-2*d, pn-d, pn);
+    }
+    pm = med3(pl, pm, pn);
+    swap2(a, pm);
+    partval = ptr2char(a);
+    pa = pb = a + 1;
+    pc = pd = a + n-1;
+
+    for (;;) {
+        while (pb <= pc && (r = ptr2char(pb)-partval) <= 0) {
+            if (r == 0) {
+                swap2(pa, pb);
+                pa++;
+            }
+            pb++;
+        }
+        while (pb <= pc && (r = ptr2char(pc)-partval) >= 0) {
+            if (r == 0) {
+                swap2(pc, pd);
+                pd--;
+            }
+            pc--;
+        }
+        if (pb > pc) break;
+        swap2(pb, pc);
+        pb++;
+        pc--;
+    }
+
+#if UNROLL
+    if (pa>pd) {
+
+        if ((next_depth = text_depth+1) >= ctx->Shallow_text_limit) {
+            helped_sort(ctx,a, n, next_depth-ctx->Text);
+            return;
+        } else {
+            text_depth = next_depth;
+            goto repeat;
+        }
+    }
+#endif
+
+    pn = a + n;
+    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
+    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
+
+    if ((r = pb-pa) > 1)
+        shallow_mkq(ctx,a, r, text_depth);
+
+    if ((next_depth = text_depth+1) < ctx->Shallow_text_limit)
+        shallow_mkq(ctx,a + r, pa-pd+n-1, next_depth);
+    else
+        helped_sort(ctx,a + r, pa-pd+n-1, next_depth-ctx->Text);
+    if ((r = pd-pc) > 1)
+        shallow_mkq(ctx,a + n-r, r, text_depth);
+}
+
+
+
+/* ************** 16 *************** */
+#define ptr2char16(i) (getword16(*(i) + text_depth))
+#define getword16(s) ((unsigned)((*(s) << 8) | *((s)+1)))
+
+#if 0
+__inline__ int32_t* med3func16(int32_t* a, int32_t* b, int32_t* c, uint8_t* text_depth)
+{
+    int va, vb, vc;
+    if ((va=ptr2char16(a)) == (vb=ptr2char16(b)))
+        return a;
+    if ((vc=ptr2char16(c)) == va || vc == vb)
+        return c;
+    return va < vb ?
+           (vb < vc ? b : (va < vc ? c : a))
+               : (vb > vc ? b : (va < vc ? a : c));
+}
+#define med3_16(a, b, c) med3func16(a, b, c, text_depth)
+#endif
+
+void shallow_mkq16(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth)
+{
+    void vecswap2(int32_t *a, int32_t *b, int n);
+    int d, r, partval;
+    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t;
+    uint8_t* next_depth;
+
+
+    if (n < ctx->Mk_qs_thresh) {
+        shallow_inssort_lcp(ctx,a, n, text_depth);
+        return;
+    }
+
+
+repeat:
+    pl = a;
+    pm = a + (n/2);
+    pn = a + (n-1);
+    if (n > 30) {
+        d = (n/8);
+        pl = med3(pl, pl+d, pl+2*d);
+        pm = med3(pm-d, pm, pm+d);
+        pn = med3(pn-2*d, pn-d, pn);
+    }
+    pm = med3(pl, pm, pn);
+    swap2(a, pm);
+    partval = ptr2char16(a);
+    pa = pb = a + 1;
+    pc = pd = a + n-1;
+
+    for (;;) {
+        while (pb <= pc && (r = ptr2char16(pb)-partval) <= 0) {
+            if (r == 0) {
+                swap2(pa, pb);
+                pa++;
+            }
+            pb++;
+        }
+        while (pb <= pc && (r = ptr2char16(pc)-partval) >= 0) {
+            if (r == 0) {
+                swap2(pc, pd);
+                pd--;
+            }
+            pc--;
+        }
+        if (pb > pc) break;
+        swap2(pb, pc);
+        pb++;
+        pc--;
+    }
+#if UNROLL
+    if (pa>pd) {
+
+        if ((next_depth = text_depth+2) >= ctx->Shallow_text_limit) {
+            helped_sort(ctx,a, n, next_depth-ctx->Text);
+            return;
+        } else {
+            text_depth = next_depth;
+            goto repeat;
+        }
+    }
+#endif
+
+    pn = a + n;
+    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
+    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
+
+    if ((r = pb-pa) > 1)
+        shallow_mkq16(ctx,a, r, text_depth);
+
+    if ((next_depth = text_depth+2) < ctx->Shallow_text_limit)
+        shallow_mkq16(ctx,a + r, pa-pd+n-1, next_depth);
+    else
+        helped_sort(ctx,a + r, pa-pd+n-1, next_depth-ctx->Text);
+    if ((r = pd-pc) > 1)
+        shallow_mkq16(ctx,a + n-r, r, text_depth);
+}
+
+
+/* *************** 32 **************** */
+#define ptr2char32(i) (getword32(*(i) + text_depth))
+#define getword32(s) ((unsigned)( (*(s) << 24) | ((*((s)+1)) << 16) \
+                                  | ((*((s)+2)) << 8) | (*((s)+3)) ))
+void shallow_mkq32(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth)
+{
+    void vecswap2(int32_t *a, int32_t *b, int n);
+    uint32_t partval, val;
+    int32_t* pa, *pb, *pc, *pd, *pl, *pm, *pn, t, d, r;
+    uint8_t* next_depth;
+
+
+    if (n < ctx->Mk_qs_thresh) {
+        shallow_inssort_lcp(ctx,a, n, text_depth);
+        return;
+    }
+
+
+repeat:
+    pl = a;
+    pm = a + (n/2);
+    pn = a + (n-1);
+    if (n > 30) {
+        d = (n/8);
+        pl = med3(pl, pl+d, pl+2*d);
+        pm = med3(pm-d, pm, pm+d);
+        pn = med3(pn-2*d, pn-d, pn);
+    }
+    pm = med3(pl, pm, pn);
+    swap2(a, pm);
+    partval = ptr2char32(a);
+    pa = pb = a + 1;
+    pc = pd = a + n-1;
+
+    for (;;) {
+        while (pb <= pc && (val=ptr2char32(pb)) <=  partval) {
+            if (val == partval) {
+                swap2(pa, pb);
+                pa++;
+            }
+            pb++;
+        }
+        while (pb <= pc && (val=ptr2char32(pc)) >= partval) {
+            if (val == partval) {
+                swap2(pc, pd);
+                pd--;
+            }
+            pc--;
+        }
+        if (pb > pc) break;
+        swap2(pb, pc);
+        pb++;
+        pc--;
+    }
+#if UNROLL
+    if (pa>pd) {
+
+        if ((next_depth = text_depth+4) >= ctx->Shallow_text_limit) {
+            helped_sort(ctx,a, n, next_depth-ctx->Text);
+            return;
+        } else {
+            text_depth = next_depth;
+            goto repeat;
+        }
+    }
+#endif
+
+    pn = a + n;
+    r = MIN(pa-a, pb-pa);    vecswap2(a,  pb-r, r);
+    r = MIN(pd-pc, pn-pd-1); vecswap2(pb, pn-r, r);
+
+    if ((r = pb-pa) > 1)
+        shallow_mkq32(ctx,a, r, text_depth);
+
+    if ((next_depth = text_depth+4) < ctx->Shallow_text_limit)
+        shallow_mkq32(ctx,a + r, pa-pd+n-1, next_depth);
+    else
+        helped_sort(ctx,a + r, pa-pd+n-1, next_depth-ctx->Text);
+    if ((r = pd-pc) > 1)
+        shallow_mkq32(ctx,a + n-r, r, text_depth);
+}
+
+
+
+/* *************** 64, cached keys ****************
+   the next 8 chars of every suffix are kept in k[] next to a[], so
+   partitioning reads the text only once per 8 levels instead of
+   once per element and partitioning step. keys move with their
+   suffix and are refreshed when the middle group goes 8 chars deeper
+   ************************************************ */
+#define getword64(s) (((uint64_t) getword32(s) << 32) | getword32((s)+4))
+#define swap64(i, j) { t = a[i]; a[i] = a[j]; a[j] = t; \
+                       kt = k[i]; k[i] = k[j]; k[j] = kt; }
+
+/* ********************************************************
+   groups of at most SMALL_SORT suffixes are sorted on their next
+   8 chars with Batcher's odd-even merge network. dropping the
+   comparators which touch a wire >= n leaves a network for n
+   inputs. the compare-exchanges have no data dependent branches;
+   runs of equal keys are finished by the lcp insertion sort
+   ******************************************************** */
+#define SMALL_SORT 16
+static const uint8_t small_network[63][2] = {
+    { 0, 1}, { 2, 3}, { 0, 2}, { 1, 3}, { 1, 2}, { 4, 5}, { 6, 7}, { 4, 6},
+    { 5, 7}, { 5, 6}, { 0, 4}, { 2, 6}, { 2, 4}, { 1, 5}, { 3, 7}, { 3, 5},
+    { 1, 2}, { 3, 4}, { 5, 6}, { 8, 9}, {10,11}, { 8,10}, { 9,11}, { 9,10},
+    {12,13}, {14,15}, {12,14}, {13,15}, {13,14}, { 8,12}, {10,14}, {10,12},
+    { 9,13}, {11,15}, {11,13}, { 9,10}, {11,12}, {13,14}, { 0, 8}, { 4,12},
+    { 4, 8}, { 2,10}, { 6,14}, { 6,10}, { 2, 4}, { 6, 8}, {10,12}, { 1, 9},
+    { 5,13}, { 5, 9}, { 3,11}, { 7,15}, { 7,11}, { 3, 5}, { 7, 9}, {11,13},
+    { 1, 2}, { 3, 4}, { 5, 6}, { 7, 8}, { 9,10}, {11,12}, {13,14}
+};
+
+static void shallow_small_sort(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth)
+{
+    uint64_t key[SMALL_SORT], ki, kj;
+    int32_t pos[SMALL_SORT], pi, pj;
+    int i, j, c, lt;
+    uint8_t* next_depth;
+
+    if (n > SMALL_SORT) {
+        shallow_inssort_lcp(ctx,a, n, text_depth);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        pos[i] = a[i];
+        key[i] = getword64(a[i] + text_depth);
+    }
+    for (c = 0; c < 63; c++) {
+        i = small_network[c][0];
+        j = small_network[c][1];
+        if (j >= n) continue;
+        ki = key[i]; kj = key[j];
+        pi = pos[i]; pj = pos[j];
+        lt = kj < ki;
+        key[i] = lt ? kj : ki; key[j] = lt ? ki : kj;
+        pos[i] = lt ? pj : pi; pos[j] = lt ? pi : pj;
+    }
+    for (i = 0; i < n; i++) a[i] = pos[i];
+
+    next_depth = text_depth+8;
+    for (i = 0; i < n; i = j) {
+        for (j = i+1; j < n && key[j] == key[i]; j++) ;
+        if (j-i < 2) continue;
+        if (next_depth >= ctx->Shallow_text_limit)
+            helped_sort(ctx,a+i, j-i, next_depth-ctx->Text);
+        else
+            shallow_inssort_lcp(ctx,a+i, j-i, next_depth);
+    }
+}
+
+static int32_t med3key(uint64_t* k, int32_t i, int32_t j, int32_t l)
+{
+    if (k[i] == k[j]) return i;
+    if (k[l] == k[i] || k[l] == k[j]) return l;
+    return k[i] < k[j] ?
+           (k[j] < k[l] ? j : (k[i] < k[l] ? l : i))
+               : (k[j] > k[l] ? j : (k[i] < k[l] ? i : l));
+}
+
+static void fill_keys(int32_t* a, uint64_t* k, int n, uint8_t* text_depth)
+{
+    int i;
+
+    for (i = 0; i < n; i++) k[i] = getword64(a[i] + text_depth);
+}
+
+static void mkq64_cached(ds_ctx_t* ctx,int32_t* a, uint64_t* k, int n, uint8_t* text_depth)
+{
+    uint64_t partval, kt;
+    int32_t pa, pb, pc, pd, pl, pm, pn, t, d, r, i;
+    uint8_t* next_depth;
+
+
+    if (n < ctx->Mk_qs_thresh) {
+        shallow_small_sort(ctx,a, n, text_depth);
+        return;
+    }
+
+
+repeat:
+    pl = 0;
+    pm = n/2;
+    pn = n-1;
+    if (n > 30) {
+        d = (n/8);
+        pl = med3key(k, pl, pl+d, pl+2*d);
+        pm = med3key(k, pm-d, pm, pm+d);
+        pn = med3key(k, pn-2*d, pn-d, pn);
+    }
+    pm = med3key(k, pl, pm, pn);
+    swap64(0, pm);
+    partval = k[0];
+    pa = pb = 1;
+    pc = pd = n-1;
+
+    for (;;) {
+        while (pb <= pc && k[pb] <= partval) {
+            if (k[pb] == partval) {
+                swap64(pa, pb);
+                pa++;
+            }
+            pb++;
+        }
+        while (pb <= pc && k[pc] >= partval) {
+            if (k[pc] == partval) {
+                swap64(pc, pd);
+                pd--;
+            }
+            pc--;
+        }
+        if (pb > pc) break;
+        swap64(pb, pc);
+        pb++;
+        pc--;
+    }
+    if (pa>pd) {
+
+        if ((next_depth = text_depth+8) >= ctx->Shallow_text_limit) {
+            helped_sort(ctx,a, n, next_depth-ctx->Text);
+            return;
+        } else {
+            text_depth = next_depth;
+            fill_keys(a, k, n, text_depth);
+            goto repeat;
+        }
+    }
+
+    pn = n;
+    r = MIN(pa, pb-pa);
+    for (i = 0; i < r; i++) swap64(i, pb-r+i);
+    r = MIN(pd-pc, pn-pd-1);
+    for (i = 0; i < r; i++) swap64(pb+i, pn-r+i);
+
+    if ((r = pb-pa) > 1)
+        mkq64_cached(ctx,a, k, r, text_depth);
+
+    if ((next_depth = text_depth+8) < ctx->Shallow_text_limit) {
+        fill_keys(a + r, k + r, pa-pd+n-1, next_depth);
+        mkq64_cached(ctx,a + r, k + r, pa-pd+n-1, next_depth);
+    } else
+        helped_sort(ctx,a + r, pa-pd+n-1, next_depth-ctx->Text);
+    if ((r = pd-pc) > 1)
+        mkq64_cached(ctx,a + n-r, k + n-r, r, text_depth);
+}
+
+void shallow_mkq64(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth)
+{
+    if (n < ctx->Mk_qs_thresh) {
+        shallow_small_sort(ctx,a, n, text_depth);
+        return;
+    }
+    if (ctx->Mkq_keys_size < n) {
+        ctx->Mkq_keys_size = MAX(n,2*ctx->Mkq_keys_size);
+        ctx->Mkq_keys = (uint64_t*) safe_realloc(ctx->Mkq_keys,
+                        ctx->Mkq_keys_size*sizeof(uint64_t));
+    }
+    fill_keys(a, ctx->Mkq_keys, n, text_depth);
+    mkq64_cached(ctx,a, ctx->Mkq_keys, n, text_depth);
+}
+
+/* >>>>>>>>>>>>>>>>>>>>>> insertion sort routines >>>>>>>>>>>>>>>>>>>
+   This insertion sort routines sorts the suffixes a[0] .. a[n-1]
+   which have a common prexif of length text_depth-Text.
+   The comparisons are done going at most at depth Shallow_limit;
+   suffixes which have Shallow_limit chars in common are sorted using
+   helped_sort().
+   This inserion_sort keeps trak of the lcp in order to speed up
+   the sorting.
+  >>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>> */
+
+/* ***********************************************************************
+   Function to compare two strings originating from the *b1 and *b2
+   The size of the unrolled loop must be at most equal to the costant
+   Cmp_overshoot defined in common.h
+   When the function is called Cmp_left must contain the maximum number of
+   comparisons the algorithm can do before returning 0 (equal strings)
+   At exit Cmp_left has been decreased by the # of comparisons done
+   *********************************************************************** */
+int32_t cmp_unrolled_shallow_lcp(ds_ctx_t* ctx,uint8_t* b1, uint8_t* b2)
+{
+
+    uint8_t c1, c2;
+    assert(b1 != b2);
+#ifdef LCP_HAVE_SIMD
+    if (ctx->Simd == LCP_AVX2) return cmp_shallow_lcp_avx2(b1,b2,&ctx->Cmp_left);
+    if (ctx->Simd == LCP_SSE2) return cmp_shallow_lcp_sse2(b1,b2,&ctx->Cmp_left);
+#endif
+
+
+
+    do {
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  1; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  2; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  3; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  4; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  5; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  6; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  7; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  8; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -=  9; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 10; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 11; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 12; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 13; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 14; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        c1 = *b1; c2 = *b2;
+        if (c1 != c2) {
+            ctx->Cmp_left -= 15; return ((uint32_t)c1 - (uint32_t)c2);
+        }
+        b1++; b2++;
+
+        ctx->Cmp_left -= 16;
+        if (ctx->Cmp_left<=0) return 0;
+
+    } while (1);
+
+    return b2 - b1;
+}
+
+/* *****************************************************************
+   this is the insertion sort routine called by multikey-quicksort
+   for sorting small groups.
+   During insertion sort the comparisons are done calling
+   cmp_unrolled_shallow_lcp() and two strings are equal if the coincides
+   for Shallow_limit characters.
+   After this first phase we sort groups of "equal_string" using
+   helped_sort().
+   Usage of lcp.
+   For i=1,...n-1 let lcp[i] denote the lcp between a[i] and a[i+1].
+   assume a[0] ... a[j-1] are already ordered and that we want to
+   insert a new element ai. If suf(ai) >= suf(a[j-1]) we are done.
+   If suf(ai)<suf(a[j-1]) we notice that: if lcpi>lcp[j-2] then
+   suf(ai)>suf(a[j-2]) and we can stop since
+   j-2 mmmmmmg
+   j-1 mmmmmmmmmmmm
+   ai  mmmmmmmmmmmf ] lcpi
+   so we write a[j-1] in position j and ai in position j-1.
+   if lcpi==lcp[j-2] then we need to compare suf(ai) with suf(a[j-2])
+   j-2 mmmmmmmmmmm?     we can have either ?<f or ?>f or ?==f
+   j-1 mmmmmmmmmmmm
+   j   mmmmmmmmmmmf
+   so we move a[j-1] to position j and compare suf(ai) with suf(a[j-2])
+   starting from lcpi.
+   Finally, if lcpi<lcp[j-2] then
+   j-2 mmmmmmmmmmmmmmmmmmg
+   j-1 mmmmmmmmmmmmmmmmmmm
+   j   mmmmmmmmmmmmmf
+   hence we have suf(ai)<suf(a[j-2]) and we consider a[j-3];
+   if lcpi<lcp[j-3] we go on look at a[j-4] and go on.
+   if lcp[j]>lcp[j-3] we are in the following position:
+   j-3 mmmmmmc
+   j-2 mmmmmmmmmmmmmmmg
+   j-1 mmmmmmmmmmmmmmmm
+   j   mmmmmmmmmmf
+   and we know that suf(ai) is larger than suf(a[j-3]). If we find that
+   lcpi==lcp[j-3] then we must compare suf(ai) with suf(a[j-3])
+   but starting with position lcpi
+   ***************************************************************** */
+void shallow_inssort_lcp(ds_ctx_t* ctx,int32_t* a, int32_t n, uint8_t* text_depth)
+{
+    int32_t cmp_unrolled_shallow_lcp(ds_ctx_t* ctx,uint8_t*, uint8_t*);
+    int32_t i, j, j1, lcp_new, r, ai,lcpi;
+    int32_t cmp_from_limit;
+    uint8_t* text_depth_ai;
+    int* lcp=ctx->lcp_aux+1;
+
+
+    ctx->lcp_aux[0] = -1;
+    for (i=0; i<n; i++) lcp[i]=0;
+
+    cmp_from_limit = ctx->Shallow_text_limit-text_depth;
+
+
+    for (i = 1; i< n ; i++) {
+        ai = a[i]; lcpi = 0;
+        text_depth_ai = ai + text_depth;
+        j=i; j1=j-1;
+        while (1) {
+
+
+            ctx->Cmp_left = cmp_from_limit-lcpi;
+            r = cmp_unrolled_shallow_lcp(ctx,lcpi+a[j1]+text_depth,lcpi+text_depth_ai);
+            lcp_new = cmp_from_limit - ctx->Cmp_left;
+            assert(r!=0 || lcp_new>= cmp_from_limit);
+
+            if (r<=0) {
+                lcp[j1]=lcp_new;
+                break;
+            }
+
+
+
+            lcpi = lcp_new;
+            do {
+                a[j] = a[j1];
+                lcp[j] = lcp[j1];
+                j=j1; j1--;
+            } while (lcpi<lcp[j1]);
+
+            if (lcpi>lcp[j1]) break;
+
+
+
+        }
+        a[j]=ai;
+        lcp[j]=lcpi;
+    }
+
+
+    for (i=0; i<n-1; i=j+1) {
+        for (j=i; j<n ; j++)
+            if (lcp[j]<cmp_from_limit) break;
+        if (j-i>0)
+            helped_sort(ctx,a+i,j-i+1,ctx->Shallow_limit);
+    }
+}
+
+
+
+/* *******************************************************************
+   create a sorting context initialised with the default parameters.
+   a context can be reused for any number of ds_ssort() calls but must
+   not be shared by two sorts running at the same time
+   ******************************************************************** */
+ds_ctx_t* ds_ctx_create(void)
+{
+    ds_ctx_t* ctx;
+
+    ctx = (ds_ctx_t*) safe_malloc(sizeof(ds_ctx_t));
+    ctx->ftab = (int32_t*) safe_malloc(65537*sizeof(int32_t));
+    ctx->Simd = lcp_simd_level();
+    ds_params_default(&ctx->Params);
+    set_ds_params(ctx);
+
+    return ctx;
+}
+
+void ds_ctx_free(ds_ctx_t* ctx)
+{
+    if (!ctx->Anchor_defer) free(ctx->ftab);
+    free(ctx->Anchor_buf);
+    free(ctx->Anchor_log);
+    free(ctx->Mkq_keys);
+    free(ctx->Stack);
+    while (ctx->Node_chunks != NULL) {
+        node_chunk_t* c = ctx->Node_chunks;
+        ctx->Node_chunks = c->next;
+        free(c->nodes);
+        free(c);
+    }
+    free(ctx);
+}
+
+
+
+/* *******************************************************************
+   procedure to be called by external program before calling ds_ssort()
+   using this procedure external programs can choose
+   the parameters Anchor_dist and Blind_sort_ratio.
+   The procedure returns 0 if something goes wrong, otherwise
+   it returns the overshhot, that is the amount of extra space
+   required at the end of the array contanining the text
+   ******************************************************************** */
+int init_ds_ssort(ds_ctx_t* ctx,int adist, int bs_ratio)
+{
+    set_ds_params(ctx);
+    ctx->Anchor_dist = adist;
+    ctx->Blind_sort_ratio=bs_ratio;
+    ctx->Shallow_limit =  ctx->Anchor_dist + 50;
+    if (check_ds_params(ctx))
+        return 0;
+    return compute_overshoot(ctx);
+}
+
+
+
+void ds_params_default(ds_params_t* p)
+{
+    p->anchor_dist = 500;
+    p->shallow_limit = 0;
+    p->blind_sort_ratio = 2000;
+    p->mk_qs_thresh = 20;
+    p->b2g_ratio = 1000;
+    p->word_size = 8;
+    p->autotune = 0;
+    p->set = 0;
+}
+
+void ds_ctx_set_params(ds_ctx_t* ctx,const ds_params_t* p)
+{
+    ctx->Params = *p;
+    set_ds_params(ctx);
+}
+
+/* copy the requested parameters of ctx->Params into the context */
+void set_ds_params(ds_ctx_t* ctx)
+{
+    ds_params_t* p = &ctx->Params;
+
+    ctx->Blind_sort_ratio = p->blind_sort_ratio;
+    ctx->Anchor_dist = p->anchor_dist;
+    ctx->Shallow_limit = p->shallow_limit ? p->shallow_limit : p->anchor_dist + 50;
+    ctx->_ds_Verbose = 0;
+    ctx->_ds_Word_size = p->word_size;
+    ctx->Mk_qs_thresh = p->mk_qs_thresh;
+    ctx->Max_pseudo_anchor_offset=0;
+    ctx->B2g_ratio = p->b2g_ratio;
+    ctx->Update_anchor_ranks=0;
+}
+
+
+
+/* *******************************************************************
+   compare the suffixes of t[0..n-1] at i and j, looking at no more
+   than DS_TUNE_MAX_LCP chars. the lcp is stored in *lcp
+   ******************************************************************* */
+static int tune_cmp(const uint8_t* t, int32_t n, int32_t i, int32_t j, int32_t* lcp)
+{
+    int32_t l, max;
+
+    max = MIN(DS_TUNE_MAX_LCP, n - MAX(i,j));
+    for (l = 0; l < max && t[i+l] == t[j+l]; l++) ;
+    *lcp = l;
+    if (l < max) return t[i+l] < t[j+l] ? -1 : 1;
+    return (l == DS_TUNE_MAX_LCP) ? 0 : (i > j ? -1 : 1);
+}
+
+/* merge sort of the sampled suffixes s[0..m-1], tmp has room for m */
+static void tune_sort(const uint8_t* t, int32_t n, int32_t* s, int32_t* tmp, int32_t m)
+{
+    int32_t h, i, j, k, l;
+
+    if (m < 2) return;
+    h = m/2;
+    tune_sort(t, n, s, tmp, h);
+    tune_sort(t, n, s+h, tmp, m-h);
+    for (i = 0, j = h, k = 0; i < h && j < m; )
+        tmp[k++] = (tune_cmp(t, n, s[i], s[j], &l) <= 0) ? s[i++] : s[j++];
+    while (i < h) tmp[k++] = s[i++];
+    while (j < m) tmp[k++] = s[j++];
+    memcpy(s, tmp, m*sizeof(int32_t));
+}
+
+/* *******************************************************************
+   sort DS_TUNE_SAMPLES evenly spaced suffixes of t[0..n-1] and return
+   the average lcp of neighbours, an estimate of how deep the groups
+   of the real sort go. with dna, the samples in a run of N or another
+   exception are left out, dna_ssort() steps over those runs. n must
+   be at least 2*DS_TUNE_SAMPLES
+   ******************************************************************* */
+static double sample_lcp(const uint8_t* t, int32_t n, int dna)
+{
+    int32_t* s, *tmp, m, i, l, p, step;
+    int64_t sum;
+
+    step = n / DS_TUNE_SAMPLES;
+    s = (int32_t*) safe_malloc(2*DS_TUNE_SAMPLES*sizeof(int32_t));
+    tmp = s + DS_TUNE_SAMPLES;
+    for (i = 0, m = 0; i < DS_TUNE_SAMPLES; i++) {
+        p = i*step + (int32_t) ((i*7919) % step);
+        if (dna && p+1 < n && t[p] == t[p+1] && !DNA_IS_BASE(t[p])) continue;
+        s[m++] = p;
+    }
+    if (m < 2) {
+        free(s);
+        return 0.0;
+    }
+    tune_sort(t, n, s, tmp, m);
+    for (i = 1, sum = 0; i < m; i++) {
+        tune_cmp(t, n, s[i-1], s[i], &l);
+        sum += l;
+    }
+    free(s);
+    return (double) sum / (m-1);
+}
+
+/* *******************************************************************
+   pick Anchor_dist, Shallow_limit and Blind_sort_ratio for t[0..n-1]
+   from the sampled lcp. a text
+   with short lcps is done by the shallow sort and keeps the defaults,
+   repetitive ones get close anchors and a low shallow limit so the
+   deep sort can use them early, plus a larger share of blind sorts.
+   a text dominated by one symbol (long runs) counts as repetitive
+   as well.
+   ******************************************************************* */
+static void autotune_ds_params(ds_ctx_t* ctx, const uint8_t* t, int32_t n)
+{
+    int32_t i, l, step, set;
+    int32_t cnt[256];
+    double avg_lcp, skew;
+
+    if (n < 2*DS_TUNE_SAMPLES) return;
+
+    step = n / DS_TUNE_SAMPLES;
+    avg_lcp = sample_lcp(t, n, 0);
+
+    /* share of the sampled positions in the most frequent symbol */
+    for (i = 0; i < 256; i++) cnt[i] = 0;
+    for (i = 0; i < n; i += step) cnt[t[i]]++;
+    for (i = 0, l = 0; i < 256; i++) l = MAX(l, cnt[i]);
+    skew = (double) l / ((n + step - 1) / step);
+
+    if (avg_lcp >= 12 || skew > 0.5) {
+        set = ctx->Params.set;
+        if (!(set & DS_SET_ADIST)) ctx->Anchor_dist = DS_TUNE_ADIST;
+        if (!(set & DS_SET_SHALLOW)) ctx->Shallow_limit = DS_TUNE_SHALLOW;
+        if (!(set & DS_SET_BLIND)) ctx->Blind_sort_ratio = DS_TUNE_BLIND;
+    }
+}
+
+/* *******************************************************************
+   set the parameters for sorting t[0..n-1] from ctx->Params, tuning
+   them on the text if requested. returns the overshoot as
+   init_ds_ssort() does. the parameters are checked once up front by
+   ds_params_check(), autotune only picks valid ones
+   ******************************************************************* */
+int ds_ssort_prepare(ds_ctx_t* ctx,const uint8_t* t,int32_t n)
+{
+    set_ds_params(ctx);
+    if (ctx->Params.autotune) autotune_ds_params(ctx,t,n);
+    return compute_overshoot(ctx);
+}
+
+
+
+/* *******************************************************************
+   the largest overshoot ds_ssort_prepare() can return for the
+   parameters of ctx, whatever the text
+   ******************************************************************* */
+int32_t bwt_padding(ds_ctx_t* ctx)
+{
+    set_ds_params(ctx);
+    if (ctx->Params.autotune && !(ctx->Params.set & DS_SET_SHALLOW))
+        ctx->Shallow_limit = MAX(ctx->Shallow_limit,DS_TUNE_SHALLOW);
+    return compute_overshoot(ctx);
+}
+
+static int check_params(int adist,int shallow,int mkqs,int blind,int b2g,int word)
+{
+    if ((adist<100) && (adist!=0)) {
+        fprintf(stderr,"Anchor distance must be 0 or greater than 99\n");
+        return 1;
+    }
+    if (adist>65535) {
+        fprintf(stderr,"Anchor distance must be less than 65536\n");
+        return 1;
+    }
+    if (shallow<2 || shallow>DS_PARAM_MAX) {
+        fprintf(stderr,"Illegal limit for shallow sort\n");
+        return 1;
+    }
+    if (mkqs<0 || mkqs>Max_thresh) {
+        fprintf(stderr,"Illegal Mk_qs_thresh parameter!\n");
+        return 1;
+    }
+    if (blind<=0 || blind>DS_PARAM_MAX) {
+        fprintf(stderr,"blind_sort ratio must be from 1 to %d!\n",DS_PARAM_MAX);
+        return 1;
+    }
+    if (b2g<=0 || b2g>DS_PARAM_MAX) {
+        fprintf(stderr,"b2g ratio must be from 1 to %d!\n",DS_PARAM_MAX);
+        return 1;
+    }
+    if (word!=1 && word!=2 && word!=4 && word!=8) {
+        fprintf(stderr,"Word size must be 1, 2, 4 or 8\n");
+        return 1;
+    }
+    return 0;
+}
+
+int check_ds_params(ds_ctx_t* ctx)
+{
+    return check_params(ctx->Anchor_dist,ctx->Shallow_limit,ctx->Mk_qs_thresh,
+                        ctx->Blind_sort_ratio,ctx->B2g_ratio,ctx->_ds_Word_size);
+}
+
+/* *******************************************************************
+   check the parameters of p once before any block is sorted, with
+   the shallow limit of 0 resolved as set_ds_params() does. returns 0
+   if they are valid, else says why on stderr and returns 1
+   ******************************************************************* */
+int ds_params_check(const ds_params_t* p)
+{
+    return check_params(p->anchor_dist,
+                        p->shallow_limit ? p->shallow_limit : p->anchor_dist+50,
+                        p->mk_qs_thresh,p->blind_sort_ratio,p->b2g_ratio,p->word_size);
+}
+
+
+
+
+int compute_overshoot(ds_ctx_t* ctx)
+{
+    return 9+(ctx->Shallow_limit+Cmp_overshoot);
+}
+
+
+void pretty_putchar(int c)
+{
+
+    if (c>=32 && c<127)
+        printf("  %c", c);
+    else if (c=='\n')
+        printf(" \\n");
+    else if (c=='\t')
+        printf(" \\t");
+    else
+        printf(" %02x", c);
+}
+
+
+int scmp3(unsigned char* p, unsigned char* q, int* l, int maxl)
+{
+    int i;
+    i = 0;
+    while (maxl>0 && *p==*q) {
+        p++; q++; i++;
+        maxl--;
+    }
+    *l = i;
+    if (maxl>0) return *p-*q;
+    return q-p;
+}
+
+
+
+
+
+
+#define BIGFREQ(b) (ctx->ftab[((b)+1) << 8] - ctx->ftab[(b) << 8])
+
+
+/* ------------------------------------------------------------------------
+   The use of Anchor_rank[] and Anchor_offset is the following:
+   Anchor_rank[i] is either -1 or contains the rank (in the list of
+   the sorted suffixes of the suffix starting at position
+     i*Anchor_dist + Anchor_offset[i].
+   Initially Anchor_rank[i] = -1 and Anchor_offset[i]=Anchor_dist,
+   then, if a suffix in position t (i*Anchor_dist <= t < (i+1)*Anchor_dist)
+   appears to be in a large group which is sorted, the rank of
+   t is stored in Anchor_rank[i], and the value t-(i*Anchor_dist)
+   is written to Anchor_offset[i]. Both vaulues can be later updated,
+   but the value in Anchor_offset[i] can only decrease, so no further
+   changes are done when Anchor_offset[i] is = 0. The invariant is:
+   if Anchor_rank[i]>=0 then
+       Sa[Anchor_rank[i]]=i*Anchor_dist+Anchor_offset[i]
+   -------------------------------------------------------------------------*/
+
+
+
+void check_ordering(int, int);
+void calc_running_order(ds_ctx_t* ctx);
+
+
+/* ****************************************************************
+   sort the unsorted small buckets [ss, j] with jlo <= j < jhi.
+   returns the number of suffixes sorted
+   **************************************************************** */
+static int32_t sort_small_buckets(ds_ctx_t* ctx,int32_t ss,int32_t jlo,int32_t jhi)
+{
+    void shallow_sort(ds_ctx_t* ctx,int32_t*, int, int);
+    int32_t j, sb, lo, hi, sorted = 0;
+
+    for (j = jlo; j < jhi; j++) {
+        if (j == ss) continue;
+        sb = (ss << 8) + j;
+        if (!(ctx->ftab[sb] & SETMASK)) {
+            lo = BUCKET_FIRST(sb);
+            hi = BUCKET_LAST(sb);
+            if (hi > lo) {
+                if (ctx->_ds_Verbose>2)
+                    fprintf(stderr,"sorting [%02x, %02x], this %d\n",
+                            ss, j, hi - lo + 1);
+                shallow_sort(ctx,ctx->Sa+lo, hi-lo+1,ctx->Shallow_limit);
+#if 0
+                check_ordering(lo, hi);
+#endif
+                sorted += (hi - lo + 1);
+            }
+        }
+        if (!ctx->Anchor_defer) ctx->ftab[sb] |= SETMASK;
+    }
+    return sorted;
+}
+
+/* a run of small buckets [ss, jlo] ... [ss, jhi-1] sorted on the pool */
+typedef struct {
+    pool_task_t task;
+    ds_ctx_t** workers;
+    int32_t ss, jlo, jhi;
+} ds_task_t;
+
+static void sort_task(void* arg,int worker)
+{
+    ds_task_t* t = (ds_task_t*) arg;
+
+    sort_small_buckets(t->workers[worker],t->ss,t->jlo,t->jhi);
+}
+
+/* ****************************************************************
+   a worker context shares the text, the suffix array, ftab and the
+   anchors of ctx but has its own blind trie and comparison state
+   **************************************************************** */
+static ds_ctx_t* ds_ctx_fork(ds_ctx_t* ctx)
+{
+    ds_ctx_t* w;
+
+    w = (ds_ctx_t*) safe_malloc(sizeof(ds_ctx_t));
+    memcpy(w,ctx,sizeof(ds_ctx_t));
+    w->Node_chunks = w->Node_cur = NULL;
+    w->Node_used = 0;
+    w->Stack = NULL;
+    w->Stack_cap = 0;
+    w->Anchor_buf = NULL;
+    w->Anchor_buf_size = 0;
+    w->Mkq_keys = NULL;
+    w->Mkq_keys_size = 0;
+    w->Pool = NULL;
+    w->Anchor_defer = 1;
+    w->Anchor_log = NULL;
+    w->Anchor_log_num = w->Anchor_log_size = 0;
+    w->Calls_helped_sort = w->Calls_deep_sort = 0;
+    w->Calls_anchor_sort_forw = w->Calls_anchor_sort_backw = 0;
+    w->Calls_pseudo_anchor_sort_forw = 0;
+    return w;
+}
+
+/* apply the anchor updates logged by w and collect its statistics */
+static void ds_ctx_join(ds_ctx_t* ctx,ds_ctx_t* w)
+{
+    int32_t i, anchor;
+
+    for (i = 0; i < w->Anchor_log_num; i += 3) {
+        anchor = w->Anchor_log[i];
+        if (w->Anchor_log[i+1] < ctx->Anchor_offset[anchor]) {
+            ctx->Anchor_offset[anchor] = w->Anchor_log[i+1];
+            ctx->Anchor_rank[anchor] = w->Anchor_log[i+2];
+        }
+    }
+    w->Anchor_log_num = 0;
+
+    ctx->Calls_helped_sort += w->Calls_helped_sort;
+    ctx->Calls_deep_sort += w->Calls_deep_sort;
+    ctx->Calls_anchor_sort_forw += w->Calls_anchor_sort_forw;
+    ctx->Calls_anchor_sort_backw += w->Calls_anchor_sort_backw;
+    ctx->Calls_pseudo_anchor_sort_forw += w->Calls_pseudo_anchor_sort_forw;
+    w->Calls_helped_sort = w->Calls_deep_sort = 0;
+    w->Calls_anchor_sort_forw = w->Calls_anchor_sort_backw = 0;
+    w->Calls_pseudo_anchor_sort_forw = 0;
+}
+
+/* ****************************************************************
+   sort the small buckets [ss, j] of big bucket ss. the small buckets
+   do not depend on each other, so if there is a pool and enough work
+   they are handed out in runs of about DS_TASK_SIZE suffixes. ftab
+   and the anchors are only read until all runs are done, then the
+   anchor updates of the workers are applied and the buckets marked.
+   returns the number of suffixes sorted
+   **************************************************************** */
+static int32_t sort_big_bucket(ds_ctx_t* ctx,ds_ctx_t** workers,int32_t ss)
+{
+    ds_task_t tasks[256];
+    int32_t i, j, jlo, sb, size, total, ntasks, sorted;
+
+    total = 0;
+    if (ctx->Pool) {
+        for (j = 0; j <= 255; j++) {
+            sb = (ss << 8) + j;
+            if (j != ss && !(ctx->ftab[sb] & SETMASK)) total += BUCKET_SIZE(sb);
+        }
+    }
+    if (total <= DS_TASK_SIZE) return sort_small_buckets(ctx,ss,0,256);
+
+    ntasks = sorted = size = 0;
+    for (jlo = j = 0; j <= 255; j++) {
+        sb = (ss << 8) + j;
+        if (j != ss && !(ctx->ftab[sb] & SETMASK) && BUCKET_SIZE(sb) > 1) {
+            size += BUCKET_SIZE(sb);
+            sorted += BUCKET_SIZE(sb);
+        }
+        if (size >= DS_TASK_SIZE || (j == 255 && size > 0)) {
+            tasks[ntasks].workers = workers;
+            tasks[ntasks].ss = ss;
+            tasks[ntasks].jlo = jlo;
+            tasks[ntasks].jhi = j+1;
+            pool_submit(ctx->Pool,&tasks[ntasks].task,sort_task,&tasks[ntasks]);
+            ntasks++;
+            jlo = j+1;
+            size = 0;
+        }
+    }
+    for (i = 0; i < ntasks; i++) pool_task_wait(ctx->Pool,&tasks[i].task);
+
+    for (i = 0; i < ctx->Pool->nthreads; i++) ds_ctx_join(ctx,workers[i]);
+    for (j = 0; j <= 255; j++)
+        if (j != ss) ctx->ftab[(ss << 8) + j] |= SETMASK;
+    return sorted;
+}
+
+/* one chunk of the text for the parallel bigram count and scatter */
+typedef struct {
+    pool_task_t task;
+    ds_ctx_t* ctx;
+    int32_t lo, hi;
+    int32_t* cnt;
+} ds_chunk_t;
+
+static void count_chunk(void* arg,int worker)
+{
+    ds_chunk_t* c = (ds_chunk_t*) arg;
+    uint8_t* t = c->ctx->Text;
+    int32_t i;
+
+    (void) worker;
+    for (i = c->lo; i < c->hi; i++) c->cnt[(t[i] << 8) + t[i+1]]++;
+}
+
+static void scatter_chunk(void* arg,int worker)
+{
+    ds_chunk_t* c = (ds_chunk_t*) arg;
+    uint8_t* t = c->ctx->Text;
+    int32_t* sa = c->ctx->Sa;
+    int32_t i;
+
+    (void) worker;
+    for (i = c->lo; i < c->hi; i++) sa[--c->cnt[(t[i] << 8) + t[i+1]]] = i;
+}
+
+/* ****************************************************************
+   count the bigrams of the text in ftab and scatter every suffix
+   into its small bucket. within a bucket the suffixes end up in
+   decreasing order of position. with a pool the text is split into
+   chunks, each counted into its own histogram; chunk c then fills
+   each bucket below the slots of chunks 0..c-1, which gives the
+   same layout as the sequential scan
+   **************************************************************** */
+static void bucket_suffixes(ds_ctx_t* ctx)
+{
+    ds_chunk_t chunks[64];
+    int32_t i, j, b, nchunks, end, cnt;
+    uint8_t c1, c2;
+
+    nchunks = 1;
+    if (ctx->Pool)
+        nchunks = MIN(MIN(ctx->Pool->nthreads,64),ctx->Text_size/DS_CHUNK_SIZE);
+
+    if (nchunks < 2) {
+        for (i = 0; i <= 65536; i++) ctx->ftab[i] = 0;
+        c1 = ctx->Text[0];
+        for (i = 1; i <= ctx->Text_size; i++) {
+            c2 = ctx->Text[i];
+            ctx->ftab[(c1 << 8) + c2]++;
+            c1 = c2;
+        }
+        for (i = 1; i <= 65536; i++) ctx->ftab[i] += ctx->ftab[i-1];
+
+
+        c1 = ctx->Text[0];
+        for (i = 0; i < ctx->Text_size; i++) {
+            c2 = ctx->Text[i+1];
+            j = (c1 << 8) + c2;
+            c1 = c2;
+            ctx->ftab[j]--;
+            ctx->Sa[ctx->ftab[j]] = i;
+        }
+        return;
+    }
+
+    for (i = 0; i < nchunks; i++) {
+        chunks[i].ctx = ctx;
+        chunks[i].lo = (int32_t) ((int64_t) ctx->Text_size*i/nchunks);
+        chunks[i].hi = (int32_t) ((int64_t) ctx->Text_size*(i+1)/nchunks);
+        chunks[i].cnt = (int32_t*) safe_malloc(65536*sizeof(int32_t));
+        pool_submit(ctx->Pool,&chunks[i].task,count_chunk,&chunks[i]);
+    }
+    for (i = 0; i < nchunks; i++) pool_task_wait(ctx->Pool,&chunks[i].task);
+
+    /* ftab[b] is the end of bucket b, chunk i starts below it after
+       the suffixes of the chunks before it */
+    for (b = 0, end = 0; b < 65536; b++) {
+        for (i = 0; i < nchunks; i++) end += chunks[i].cnt[b];
+        ctx->ftab[b] = end;
+    }
+    ctx->ftab[65536] = end;
+    for (b = 0; b < 65536; b++) {
+        end = ctx->ftab[b];
+        for (i = 0; i < nchunks; i++) {
+            cnt = chunks[i].cnt[b];
+            chunks[i].cnt[b] = end;
+            end -= cnt;
+        }
+        ctx->ftab[b] = end;
+    }
+
+    for (i = 0; i < nchunks; i++)
+        pool_submit(ctx->Pool,&chunks[i].task,scatter_chunk,&chunks[i]);
+    for (i = 0; i < nchunks; i++) {
+        pool_task_wait(ctx->Pool,&chunks[i].task);
+        free(chunks[i].cnt);
+    }
+}
+
+/* ************************************************************
+   This is the main deep/shallow suffix sorting routines
+   It divides the suffixes in buckets according to the
+   first two characters. Some of the buckets are then sorted
+   calling shallow_sort(). When all buckets of kind ax (x!=a) are
+   sorted, we use this ordering to sort all suffixes in the
+   buckets ya (for any y including y=a).
+   ************************************************************* */
+void ds_ssort(ds_ctx_t* ctx,uint8_t* x, int32_t* p, int32_t n)
+{
+    int compute_overshoot(ds_ctx_t* ctx), overshoot;
+    int32_t  i, j, ss, k;
+    uint8_t  c1;
+    uint8_t   bigDone[256];
+    int32_t  copyStart[256];
+    int32_t  copyEnd  [256];
+    int32_t  numQSorted = 0;
+    ds_ctx_t** workers = NULL;
+
+
+    ctx->Text=x;
+    ctx->Text_size=n;
+    ctx->Sa = p;
+    ctx->Upper_text_limit = ctx->Text + ctx->Text_size;
+    ctx->Calls_helped_sort = ctx->Calls_deep_sort = 0;
+    ctx->Calls_anchor_sort_forw = ctx->Calls_anchor_sort_backw = 0;
+    ctx->Calls_pseudo_anchor_sort_forw = 0;
+    memset(ctx->bucket_ranked,0,sizeof(ctx->bucket_ranked));
+
+    overshoot = compute_overshoot(ctx);
+    for (i=n; i<n+overshoot; i++) ctx->Text[i]=0;
+
+
+    if (ctx->Anchor_dist==0) {
+        ctx->Anchor_num=0; ctx->Anchor_rank=NULL; ctx->Anchor_offset=NULL;
+    } else {
+        ctx->Anchor_num = 2 + (n-1)/ctx->Anchor_dist;
+        ctx->Anchor_rank = (int32_t*) malloc(ctx->Anchor_num*sizeof(int32_t));
+        ctx->Anchor_offset = (uint16_t*) malloc(ctx->Anchor_num*sizeof(uint16_t));
+        if (!ctx->Anchor_rank || !ctx->Anchor_offset) {
+            fprintf(stderr, "malloc failed (ds_sort)\n");
+            exit(1);
+        }
+        for (i=0; i<ctx->Anchor_num; i++) {
+            ctx->Anchor_rank[i]= -1;
+            ctx->Anchor_offset[i] = ctx->Anchor_dist;
+        }
+    }
+
+
+    bucket_suffixes(ctx);
+
+    /* decide on the running order */
+    calc_running_order(ctx);
+    if (ctx->Pool) {
+        workers = (ds_ctx_t**) safe_malloc(ctx->Pool->nthreads*sizeof(ds_ctx_t*));
+        for (i = 0; i < ctx->Pool->nthreads; i++) workers[i] = ds_ctx_fork(ctx);
+    }
+    for (i = 0; i < 256; i++) bigDone[i] = FALSE;
+
+    /* Really do the suffix sorting */
+    for (i = 0; i <= 255; i++) {
+
+        /*--
+          Process big buckets, starting with the least full.
+          --*/
+        ss = ctx->runningOrder[i];
+        if (ctx->_ds_Verbose>2)
+            fprintf(stderr,"group %3d;  size %d\n",ss,BIGFREQ(ss)&CLEARMASK);
+
+        /*--
+          Complete the big bucket [ss] by sorting
+          any unsorted small buckets [ss, j].  Hopefully
+          previous pointer-scanning phases have already
+          completed many of the small buckets [ss, j], so
+          we don't have to sort them at all.
+          --*/
+        numQSorted += sort_big_bucket(ctx,workers,ss);
+        assert(!bigDone[ss]);
+
+        {
+            for (j = 0; j <= 255; j++) {
+                copyStart[j] =  ctx->ftab[(j << 8) + ss]     & CLEARMASK;
+                copyEnd  [j] = (ctx->ftab[(j << 8) + ss + 1] & CLEARMASK) - 1;
+            }
+
+            if (ss==0) {
+                k=ctx->Text_size-1;
+                c1 = ctx->Text[k];
+                if (!bigDone[c1])
+                    ctx->Sa[ copyStart[c1]++ ] = k;
+            }
+            for (j = ctx->ftab[ss << 8] & CLEARMASK; j < copyStart[ss]; j++) {
+                k = ctx->Sa[j]-1; if (k < 0) continue;
+                c1 = ctx->Text[k];
+                if (!bigDone[c1])
+                    ctx->Sa[ copyStart[c1]++ ] = k;
+            }
+            for (j = (ctx->ftab[(ss+1) << 8] & CLEARMASK) - 1; j > copyEnd[ss]; j--) {
+                k = ctx->Sa[j]-1; if (k < 0) continue;
+                c1 = ctx->Text[k];
+                if (!bigDone[c1])
+                    ctx->Sa[ copyEnd[c1]-- ] = k;
+            }
+        }
+        assert(copyStart[ss] - 1 == copyEnd[ss]);
+        for (j = 0; j <= 255; j++) ctx->ftab[(j << 8) + ss] |= SETMASK;
+        bigDone[ss] = TRUE;
+    }
+    if (ctx->_ds_Verbose) {
+        fprintf(stderr, "\t %d pointers, %d sorted, %d scanned\n",
+                ctx->Text_size, numQSorted, ctx->Text_size - numQSorted);
+        fprintf(stderr, "\t %d calls to helped_sort\n",ctx->Calls_helped_sort);
+        fprintf(stderr, "\t %d calls to anchor_sort (forward)\n",
+                ctx->Calls_anchor_sort_forw);
+        fprintf(stderr, "\t %d calls to anchor_sort (backward)\n",
+                ctx->Calls_anchor_sort_backw);
+        fprintf(stderr, "\t %d calls to pseudo_anchor_sort (forward)\n",
+                ctx->Calls_pseudo_anchor_sort_forw);
+        fprintf(stderr, "\t %d calls to deep_sort\n",ctx->Calls_deep_sort);
+    }
+
+    if (ctx->Pool) {
+        for (i = 0; i < ctx->Pool->nthreads; i++) ds_ctx_free(workers[i]);
+        free(workers);
+    }
+    free(ctx->Anchor_offset);
+    free(ctx->Anchor_rank);
+}
+
+
+
+/* ****************************************************************
+   compute running =(sorting) order for big buckets: start with
+   the least full and proceed to the largest one.
+   The sorting is done using shellsort
+   **************************************************************** */
+
+void calc_running_order(ds_ctx_t* ctx)
+{
+    int32_t i, j;
+    for (i = 0; i <= 255; i++) ctx->runningOrder[i] = i;
+
+    {
+        int32_t vv;
+        int32_t h = 1;
+        do h = 3 * h + 1; while (h <= 256);
+        do {
+            h = h / 3;
+            for (i = h; i <= 255; i++) {
+                vv = ctx->runningOrder[i];
+                j = i;
+                while (BIGFREQ(ctx->runningOrder[j-h]) > BIGFREQ(vv)) {
+                    ctx->runningOrder[j] = ctx->runningOrder[j-h];
+                    j = j - h;
+                    if (j <= (h - 1)) goto zero;
+                }
+zero:
+                ctx->runningOrder[j] = vv;
+            }
+        } while (h != 1);
+    }
+}
+
+
+/* ***************************************************************
+   bwt of input[0..n-1] into out[0..n-1]. besides the primary index
+   idx[0] = I (the row of the suffix starting at text position 0)
+   we record the rows of the suffixes starting at j*bwt_index_step(n,k)
+   in idx[j] for 0 < j < k, so the inverse can decode k segments of
+   the text independently.
+   the suffixes are sorted with ds_ssort() or, for BWT_SORT_SAIS, with
+   sais_ssort() which needs neither the overshoot copy of the text nor
+   ctx, and takes linear time on highly repetitive input. BWT_SORT_DNA
+   sorts with dna_ssort(), which needs no overshoot either. *sorter is
+   used as given, the caller resolves it with bwt_fit_sorter() once,
+   only blocks of DS_MAX_SIZE or more always use sa-is. the sorter
+   that was used is stored back in *sorter. the 32 bit
+   suffix array is kept for blocks up to INT32_MAX, larger ones use 64
+   bit indices.
+   blocks up to SMALL_MAX_SIZE are sorted with 16 bit indices by
+   small_bwt() (BWT_SORT_SMALL) whatever the sorter but dna, unless
+   they have long repeats.
+   if out is NULL the bwt is written over the suffix array, which is
+   then shrunk to n bytes and returned (free_large() it). this saves the
+   separate n byte output buffer; with BWT_SORT_SAIS the peak is the
+   input plus the suffix array.
+   ds_ssort() needs the overshoot after the text. if input has pad
+   writable bytes after input[n-1] and pad is at least bwt_padding()
+   it is sorted in place, the padding is overwritten. otherwise it is
+   sorted in a padded copy.
+   *************************************************************** */
+static uint8_t*
+transform_bwt64(uint8_t* input,int64_t n,uint8_t* out,int64_t* idx,int64_t step)
+{
+    int64_t* sa;
+
+    sa = (int64_t*) safe_malloc_large(n*sizeof(int64_t));
+    sais_bwt64(input,out ? out : (uint8_t*) sa,sa,n,idx,step);
+
+    if (out != NULL) free_large(sa);
+    else out = (uint8_t*) safe_shrink_large(sa,n);
+
+    return out;
+}
+
+/* small_bwt() with 16 bit indices. NULL if the block has repeats too
+   long for it, out is left alone then */
+static uint8_t*
+transform_bwt16(uint8_t* input,int64_t n,uint8_t* out,int64_t* idx,int32_t k)
+{
+    uint16_t* sa;
+    int32_t idx32[BWT_MAX_INDEX];
+    int32_t j;
+
+    sa = (uint16_t*) safe_malloc_large(n*sizeof(uint16_t));
+    for (j=0; j<k; j++) idx32[j] = 0;
+    if (!small_bwt(input,out ? out : (uint8_t*) sa,sa,(int32_t) n,idx32,
+                   (int32_t) bwt_index_step(n,k))) {
+        free_large(sa);
+        return NULL;
+    }
+    for (j=0; j<k; j++) idx[j] = idx32[j];
+
+    if (out != NULL) free_large(sa);
+    else out = (uint8_t*) safe_shrink_large(sa,n);
+
+    return out;
+}
+
+/* ***************************************************************
+   pick the suffix sorter for t[0..n-1]. deep-shallow is fastest
+   while the lcps are short, sa-is does not slow down on repetitive
+   text. the sampled lcp of DS_TUNE_SAMPLES suffixes tells them apart.
+   blocks up to SMALL_MAX_SIZE are sorted by small_bwt() unless they
+   have long repeats, so those go to sa-is. nucleotide sequences go to
+   dna_ssort() unless they are too repetitive for it as well
+   *************************************************************** */
+bwt_sorter_t bwt_choose_sorter(const uint8_t* t,int64_t n)
+{
+    double lcp;
+
+    if (n >= DS_MAX_SIZE || n <= SMALL_MAX_SIZE) return BWT_SORT_SAIS;
+    if (n < 2*DS_TUNE_SAMPLES) return BWT_SORT_DS;
+    if (dna_block(t,n))
+        return (sample_lcp(t,(int32_t) n,1) < BWT_DNA_LCP) ? BWT_SORT_DNA : BWT_SORT_SAIS;
+    lcp = sample_lcp(t,(int32_t) n,0);
+    if (lcp >= BWT_AUTO_LCP) return BWT_SORT_SAIS;
+    return BWT_SORT_DS;
+}
+
+/* ***************************************************************
+   the sorter to use on t[0..n-1] when sorter is asked for. auto and
+   blocks of DS_MAX_SIZE or more go by bwt_choose_sorter(). ds and dna
+   blocks with a sampled lcp of BWT_DS_MAX_LCP or more go to sa-is, a
+   block of zeros is still periodic after RLE1 and would take
+   ds_ssort() seconds per megabyte. so do dna blocks that are not a
+   dna_block(), dna_ssort() cuts its words at every other symbol
+   *************************************************************** */
+bwt_sorter_t bwt_fit_sorter(const uint8_t* t,int64_t n,bwt_sorter_t sorter)
+{
+    int dna = (sorter == BWT_SORT_DNA);
+
+    if (sorter == BWT_SORT_AUTO || n >= DS_MAX_SIZE) return bwt_choose_sorter(t,n);
+    if (dna && !dna_block(t,n)) return BWT_SORT_SAIS;
+    if ((sorter == BWT_SORT_DS || dna) && n >= 2*DS_TUNE_SAMPLES &&
+        sample_lcp(t,(int32_t) n,dna) >= BWT_DS_MAX_LCP) return BWT_SORT_SAIS;
+    return sorter;
+}
+
+/* ***************************************************************
+   gather of the last column from the suffix array sorted by
+   ds_ssort(). buf[i-lo] = txt[sa[i]-1] for lo <= i < hi, the row of
+   the suffix at 0 is stored in zero (-1 if it is not in the range)
+   and the rows of the sampled positions in idx. the text is read
+   BWT_PREFETCH_DIST suffixes ahead, so the cache misses of the
+   random reads overlap. the sampled positions are the multiples of
+   step, which are told apart without a division: with step = o*2^e
+   and o odd, s is one iff s times the inverse of o mod 2^32, rotated
+   right by e, is at most (2^32-1)/step.
+   *************************************************************** */
+typedef struct {
+    pool_task_t task;
+    const uint8_t* txt;
+    const int32_t* sa;
+    int32_t lo, hi, step, zero;
+    uint32_t inv, lim;
+    int32_t shift;
+    int32_t* idx;
+    uint8_t* buf;
+} bwt_gather_t;
+
+/* the constants of the multiple of step test above */
+static void gather_set_step(bwt_gather_t* g,int32_t step)
+{
+    uint32_t o = (uint32_t) step, inv;
+    int32_t e = 0;
+
+    while (!(o & 1)) {
+        o >>= 1;
+        e++;
+    }
+    /* newton's iteration doubles the correct low bits, o*o = 1 mod 8 */
+    inv = o;
+    inv *= 2 - o*inv;
+    inv *= 2 - o*inv;
+    inv *= 2 - o*inv;
+    inv *= 2 - o*inv;
+    g->step = step;
+    g->inv = inv;
+    g->shift = e;
+    g->lim = 0xffffffffU / (uint32_t) step;
+}
+
+static void gather_bwt(void* arg,int worker)
+{
+    bwt_gather_t* g = (bwt_gather_t*) arg;
+    const uint8_t* txt = g->txt;
+    const int32_t* sa = g->sa;
+    int32_t i, s, pf;
+    uint32_t x;
+
+    (void) worker;
+    g->zero = -1;
+    pf = g->hi - BWT_PREFETCH_DIST;
+    for (i = g->lo; i < g->hi; i++) {
+        if (i < pf) BWT_PREFETCH(txt + sa[i+BWT_PREFETCH_DIST]);
+        s = sa[i];
+        x = (uint32_t) s * g->inv;
+        if (g->shift) x = (x >> g->shift) | (x << (32 - g->shift));
+        if (x <= g->lim) g->idx[s / g->step] = i;
+        if (s == 0) g->zero = i;
+        else g->buf[i - g->lo] = txt[s-1];
+    }
+}
+
+/* ***************************************************************
+   write the bwt of txt[0..n-1] from its suffix array to bwt, which
+   may be sa itself. the rows are gathered in rounds of one
+   BWT_GATHER_CHUNK per thread of ctx->Pool (or one) into buffers,
+   then row i is copied to bwt[i+1] before the row of the suffix at
+   0 and to bwt[i] after it. a round ending before row hi writes no
+   further than bwt[hi], so it never reaches sa[hi..n-1] of the later
+   rounds
+   *************************************************************** */
+static void emit_bwt(ds_ctx_t* ctx,const uint8_t* txt,const int32_t* sa,int32_t n,
+                     uint8_t* bwt,int32_t step,int32_t* idx)
+{
+    bwt_gather_t g[BWT_MAX_GATHER];
+    uint8_t* buf;
+    int32_t i, t, nt, lo, len, zero, chunk;
+
+    nt = ctx->Pool ? MIN(ctx->Pool->nthreads,BWT_MAX_GATHER) : 1;
+    chunk = MIN(BWT_GATHER_CHUNK, n);
+    buf = (uint8_t*) safe_malloc((size_t) nt*chunk);
+    zero = -1;
+    for (lo = 0; lo < n; ) {
+        for (t = 0; t < nt && lo < n; t++, lo += len) {
+            len = MIN(chunk, n - lo);
+            g[t].txt = txt;
+            g[t].sa = sa;
+            g[t].lo = lo;
+            g[t].hi = lo + len;
+            gather_set_step(&g[t],step);
+            g[t].idx = idx;
+            g[t].buf = buf + (size_t) t*chunk;
+            if (nt > 1) pool_submit(ctx->Pool,&g[t].task,gather_bwt,&g[t]);
+            else gather_bwt(&g[t],0);
+        }
+        if (nt > 1)
+            for (i = 0; i < t; i++) pool_task_wait(ctx->Pool,&g[i].task);
+
+        if (g[0].lo == 0) bwt[0] = txt[n-1];
+        for (i = 0; i < t; i++) {
+            if (g[i].zero >= 0) zero = g[i].zero;
+            len = g[i].hi - g[i].lo;
+            if (zero < 0 || zero >= g[i].hi) {
+                memcpy(bwt + g[i].lo + 1, g[i].buf, len);
+            } else if (zero < g[i].lo) {
+                memcpy(bwt + g[i].lo, g[i].buf, len);
+            } else {
+                memcpy(bwt + g[i].lo + 1, g[i].buf, zero - g[i].lo);
+                memcpy(bwt + zero + 1, g[i].buf + (zero - g[i].lo) + 1, g[i].hi - zero - 1);
+            }
+        }
+    }
+    free(buf);
+}
+
+uint8_t* transform_bwt_sampled(ds_ctx_t* ctx,bwt_sorter_t* sorter,uint8_t* input,
+                               int64_t n,uint8_t* out,int64_t* idx,int32_t k,
+                               int64_t pad)
+{
+    int32_t overshoot;
+    int32_t* sa;
+    int32_t j,step;
+    int32_t idx32[BWT_MAX_INDEX];
+    uint8_t* txt,*bwt;
+
+    if (k < 1 || k > BWT_MAX_INDEX) fatal("invalid number of primary indices %d.",k);
+    for (j=0; j<k; j++) idx[j] = 0;
+
+    if (n >= DS_MAX_SIZE) *sorter = BWT_SORT_SAIS;
+    if (n > INT32_MAX) return transform_bwt64(input,n,out,idx,bwt_index_step(n,k));
+    if (n <= SMALL_MAX_SIZE && *sorter != BWT_SORT_DNA) {
+        if ((bwt = transform_bwt16(input,n,out,idx,k)) != NULL) {
+            *sorter = BWT_SORT_SMALL;
+            return bwt;
+        }
+        /* long repeats, left to the sorter asked for */
+    }
+
+    sa = safe_malloc_large(n*sizeof(int32_t));
+    bwt = (out != NULL) ? out : (uint8_t*) sa;
+
+    step = bwt_index_step(n,k);
+    for (j=0; j<k; j++) idx32[j] = 0;
+
+    /* repeats too deep for dna_ssort() go to sa-is */
+    if (*sorter == BWT_SORT_DNA && !dna_ssort(input,sa,n,ctx->Pool))
+        *sorter = BWT_SORT_SAIS;
+
+    if (*sorter == BWT_SORT_SAIS) {
+        /* induces the bwt directly, no pass over the suffix array */
+        sais_bwt(input,bwt,sa,n,idx32,step);
+    } else if (*sorter == BWT_SORT_DNA) {
+        /* sorted above, needs no overshoot either */
+        emit_bwt(ctx,input,sa,n,bwt,step,idx32);
+    } else {
+        *sorter = BWT_SORT_DS;
+        overshoot=ds_ssort_prepare(ctx,input,n);
+        if (overshoot == 0) fatal("invalid deep-shallow parameters.");
+
+        if (pad >= overshoot) txt = input;
+        else {
+            txt = safe_malloc_large((n+overshoot)*sizeof(uint8_t));
+            memcpy(txt,input,n);
+        }
+
+        ds_ssort(ctx,txt,sa,n);
+        emit_bwt(ctx,txt,sa,n,bwt,step,idx32);
+
+        if (txt != input) free_large(txt);
+    }
+    for (j=0; j<k; j++) idx[j] = idx32[j];
+
+    if (out != NULL) free_large(sa);
+    else out = (uint8_t*) safe_shrink_large(sa,n);
+
+    return out;
+}
+
+uint8_t* transform_bwt(ds_ctx_t* ctx,bwt_sorter_t sorter,uint8_t* input,int64_t n,
+                       uint8_t* out,int64_t* I)
+{
+    sorter = bwt_fit_sorter(input,n,sorter);
+    return transform_bwt_sampled(ctx,&sorter,input,n,out,I,1,0);
+}
+
+/* distance between the text positions sampled by transform_bwt_sampled */
+int64_t bwt_index_step(int64_t n,int32_t k)
+{
+    return MAX((n + k - 1) / k,1);
+}
+
+/* number of primary indices worth storing for a block of size n */
+int32_t bwt_num_index(int64_t n)
+{
+    return MIN(BWT_MAX_INDEX,MAX(n / BWT_INDEX_SPACING,1));
+}
+
+
+/* ***************************************************************
+   inverse of transform_bwt(). in[] holds the last column of the
+   matrix of the sorted suffixes of input$ with the $ removed; row I+1
+   is where the $ was. for every row r of the first column we store the
+   row of the suffix starting one character later together with the
+   first character of row r in a single word, so the text is recovered
+   front to back with one random access per output byte instead of the
+   two dependent ones (lf[] and in[]) of the classic LF walk.
+   rows fit in 24 bits as long as n < 2^24, larger blocks use 64 bit
+   entries.
+   with k primary indices the k segments of the text are decoded
+   round robin. the chains are independent so their cache misses
+   overlap instead of being paid one after the other.
+   *************************************************************** */
+#define PSI_MAX_32 ((1 << 24) - 1)
+
+static void
+count_bwt_symbols(uint8_t* in,int64_t n,int64_t* C)
+{
+    int64_t i,sum,tmp;
+
+    memset(C,0,ALPHABET_SIZE*sizeof(int64_t));
+    for (i=0; i<n; i++) C[in[i]]++;
+    sum = 1; /* row 0 of the first column is the $ */
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        tmp = C[i];
+        C[i] = sum;
+        sum += tmp;
+    }
+}
+
+/* output position of every segment, returns the length of the last
+   (shortest) segment */
+static int64_t
+init_segments(int64_t n,int32_t k,int64_t* step,uint8_t** pos,uint8_t* out)
+{
+    int32_t j;
+
+    *step = bwt_index_step(n,k);
+    for (j=0; j<k; j++) pos[j] = out + j * *step;
+    return n - (k-1) * *step;
+}
+
+static void
+reverse_bwt32(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out)
+{
+    int64_t C[ALPHABET_SIZE];
+    uint8_t* pos[BWT_MAX_INDEX];
+    uint32_t r[BWT_MAX_INDEX];
+    uint32_t* psi;
+    uint32_t w;
+    int64_t step,last;
+    int32_t i,j,I;
+
+    count_bwt_symbols(in,n,C);
+
+    /* row n+1 of the full last column is in[n], row I+1 is the $ */
+    I = idx[0];
+    psi = (uint32_t*) safe_malloc_large((n+1)*sizeof(uint32_t));
+    for (i=0; i<=I; i++) psi[C[in[i]]++] = ((uint32_t)i << 8) | in[i];
+    for (i=I+1; i<n; i++) psi[C[in[i]]++] = ((uint32_t)(i+1) << 8) | in[i];
+
+    /* row idx[j]+1 is the suffix starting at j*step */
+    last = init_segments(n,k,&step,pos,out);
+    for (j=0; j<k; j++) r[j] = idx[j]+1;
+
+    for (i=0; i<last; i++) {
+        for (j=0; j<k; j++) {
+            w = psi[r[j]];
+            *pos[j]++ = (uint8_t) w;
+            r[j] = w >> 8;
+        }
+    }
+    for (; i<step; i++) {
+        for (j=0; j<k-1; j++) {
+            w = psi[r[j]];
+            *pos[j]++ = (uint8_t) w;
+            r[j] = w >> 8;
+        }
+    }
+
+    free_large(psi);
+}
+
+static void
+reverse_bwt64(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out)
+{
+    int64_t C[ALPHABET_SIZE];
+    uint8_t* pos[BWT_MAX_INDEX];
+    uint64_t r[BWT_MAX_INDEX];
+    uint64_t* psi;
+    uint64_t w;
+    int64_t i,I,step,last;
+    int32_t j;
+
+    count_bwt_symbols(in,n,C);
+
+    I = idx[0];
+    psi = (uint64_t*) safe_malloc_large((n+1)*sizeof(uint64_t));
+    for (i=0; i<=I; i++) psi[C[in[i]]++] = ((uint64_t)i << 8) | in[i];
+    for (i=I+1; i<n; i++) psi[C[in[i]]++] = ((uint64_t)(i+1) << 8) | in[i];
+
+    last = init_segments(n,k,&step,pos,out);
+    for (j=0; j<k; j++) r[j] = idx[j]+1;
+
+    for (i=0; i<last; i++) {
+        for (j=0; j<k; j++) {
+            w = psi[r[j]];
+            *pos[j]++ = (uint8_t) w;
+            r[j] = w >> 8;
+        }
+    }
+    for (; i<step; i++) {
+        for (j=0; j<k-1; j++) {
+            w = psi[r[j]];
+            *pos[j]++ = (uint8_t) w;
+            r[j] = w >> 8;
+        }
+    }
+
+    free_large(psi);
+}
+
+static void
+check_indices(int64_t n,int64_t* idx,int32_t k)
+{
+    int32_t j;
+
+    if (k < 1 || k > BWT_MAX_INDEX || (k-1) * bwt_index_step(n,k) >= n)
+        fatal("invalid number of primary indices %d.",k);
+    for (j=0; j<k; j++)
+        if (idx[j] < 0 || idx[j] >= n) fatal("invalid primary index %ld.",(long)idx[j]);
+}
+
+/* bytes reverse_bwt_sampled() needs besides in and out: 4n, or 8n
+   above PSI_MAX_32, the whole file of an external memory archive */
+uint64_t reverse_bwt_space(int64_t n)
+{
+    return (uint64_t) (n+1) * (n <= PSI_MAX_32 ? sizeof(uint32_t) : sizeof(uint64_t));
+}
+
+uint8_t* reverse_bwt_sampled(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out)
+{
+    if (n <= 0) return out;
+    check_indices(n,idx,k);
+
+    if (n <= PSI_MAX_32) reverse_bwt32(in,n,idx,k,out);
+    else reverse_bwt64(in,n,idx,k,out);
+
+    return out;
+}
+
+/* bytes reverse_bwt_lowmem() needs besides in and out, about n */
+uint64_t reverse_bwt_lowmem_space(int64_t n)
+{
+    return rank_space(n,BWT_LOWMEM_LOG);
+}
+
+/* ***************************************************************
+   reverse_bwt_sampled() for blocks whose psi array does not fit. the
+   text is decoded back to front by the classic LF walk, with the
+   occurrences counted by a rank_t over in[] instead of an lf[] array.
+   segment j starts at the row of the suffix where segment j+1 starts,
+   the last one at row 0, the empty suffix. unlike the psi arrays the
+   segments are not decoded round robin, the scans of in[] around the
+   samples are faster one chain at a time. a row past the $ is
+   in[row-1], so in[0..r) are the rows before the row of in[r]
+   *************************************************************** */
+uint8_t* reverse_bwt_lowmem(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out)
+{
+    int64_t C[ALPHABET_SIZE];
+    int64_t I,step,p,end,row,r;
+    rank_t occ;
+    int32_t j;
+    int c;
+
+    if (n <= 0) return out;
+    check_indices(n,idx,k);
+
+    count_bwt_symbols(in,n,C);
+    rank_init(&occ,in,n,BWT_LOWMEM_LOG);
+    I = idx[0];
+    step = bwt_index_step(n,k);
+    for (j=0; j<k; j++) {
+        p = (j == k-1) ? n : (j+1)*step;
+        row = (j == k-1) ? 0 : idx[j+1]+1;
+        for (end = j*step; p > end; ) {
+            r = (row <= I) ? row : row-1;
+            c = in[r];
+            out[--p] = (uint8_t) c;
+            row = C[c] + rank_get(&occ,c,r);
+        }
+    }
+    rank_free(&occ);
+
+    return out;
+}
+
+uint8_t* reverse_bwt(uint8_t* in,int64_t n,int64_t I,uint8_t* out)
+{
+    return reverse_bwt_sampled(in,n,&I,1,out);
+}
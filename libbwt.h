@@ -1,43 +1,250 @@
-/*
- * File:   libbwt.h
- * Author: Matthias Petri
- *
- */
-
-#ifndef LIBBWT_H
-#define	LIBBWT_H
-
-#ifdef	__cplusplus
-extern "C" {
-#endif
-
-#define Cmp_overshoot 16
-#define Max_thresh 30
-
-#define SETMASK (1 << 30)
-#define CLEARMASK (~(SETMASK))
-#define IS_SORTED_BUCKET(sb) (ftab[sb] & SETMASK)
-#define BUCKET_FIRST(sb) (ftab[sb]&CLEARMASK)
-#define BUCKET_LAST(sb) ((ftab[sb+1]&CLEARMASK)-1)
-#define BUCKET_SIZE(sb) ((ftab[sb+1]&CLEARMASK)-(ftab[sb]&CLEARMASK))
-
-    uint8_t* transform_bwt(uint8_t* input,int32_t n,uint8_t* out,int32_t* I);
-    uint8_t* reverse_bwt(uint8_t* in,int32_t n,int32_t I,uint8_t* out);
-
-
-    void helped_sort(int32_t* a, int32_t n, int32_t depth);
-    void shallow_inssort_lcp(int32_t* a, int32_t n, uint8_t* text_depth);
-
-    void shallow_mkq(int32_t* a, int n, uint8_t* text_depth);
-    void shallow_mkq16(int32_t* a, int n, uint8_t* text_depth);
-    void shallow_mkq32(int32_t* a, int n, uint8_t* text_depth);
-
-    void ds_ssort(unsigned char* t, int* sa, int n);
-    int init_ds_ssort(int adist, int bs_ratio);
-
-#ifdef	__cplusplus
-}
-#endif
-
-#endif	/* LIBBWT_H */
-
+/*
+ * File:   libbwt.h
+ * Author: Matthias Petri
+ *
+ */
+
+#ifndef LIBBWT_H
+#define	LIBBWT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+#include "libpool.h"
+#include "liblcp.h"
+
+/* bytes compared past a limit, the unrolled loops compare 16 at a time
+   and the vectorised ones in liblcp.c 32 */
+#define Cmp_overshoot LCP_OVERSHOOT
+#define Max_thresh 30
+
+#define SETMASK (1 << 30)
+#define CLEARMASK (~(SETMASK))
+#define IS_SORTED_BUCKET(sb) (ctx->ftab[sb] & SETMASK)
+#define BUCKET_FIRST(sb) (ctx->ftab[sb]&CLEARMASK)
+#define BUCKET_LAST(sb) ((ctx->ftab[sb+1]&CLEARMASK)-1)
+#define BUCKET_SIZE(sb) ((ctx->ftab[sb+1]&CLEARMASK)-(ctx->ftab[sb]&CLEARMASK))
+
+/* nodes in the first chunk of the blind trie arena, later chunks
+   double up to BUFSIZE_MAX */
+#define BUFSIZE 1000
+#define BUFSIZE_MAX (1024*1024)
+
+/* with a pool, big buckets with more unsorted suffixes than this are
+   split into tasks of about this many suffixes */
+#define DS_TASK_SIZE (64*1024)
+/* and the bigram count is split into chunks of at least this size */
+#define DS_CHUNK_SIZE (1024*1024)
+
+/* the last column is gathered from the suffix array in chunks of
+   this many rows per thread, at most BWT_MAX_GATHER threads. the text
+   is prefetched BWT_PREFETCH_DIST rows ahead */
+#define BWT_GATHER_CHUNK (256*1024)
+#define BWT_MAX_GATHER 64
+#define BWT_PREFETCH_DIST 32
+#if defined(__GNUC__)
+#define BWT_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define BWT_PREFETCH(p) ((void) 0)
+#endif
+
+/* at most this many primary indices per block, one per
+   BWT_INDEX_SPACING bytes of text */
+#define BWT_MAX_INDEX 16
+#define BWT_INDEX_SPACING (256*1024)
+
+/* ds_ssort marks sorted buckets with bit 30 of ftab[], so it sorts
+   less than 2^30 suffixes. larger blocks are sorted with sa-is, with
+   64 bit indices above INT32_MAX */
+#define DS_MAX_SIZE (SETMASK-1)
+
+    /* suffix sorters transform_bwt can use */
+    typedef enum {
+        BWT_SORT_DS,    /* deep-shallow, fast on typical text */
+        BWT_SORT_SAIS,  /* induced sorting, linear time on any text */
+        BWT_SORT_DNA,   /* packed 2 bit alphabet, for nucleotide sequences */
+        BWT_SORT_SMALL, /* 16 bit small_bwt(), only reported back */
+        BWT_SORT_AUTO   /* one of them, picked per block by bwt_choose_sorter */
+    } bwt_sorter_t;
+
+/* BWT_SORT_AUTO uses sa-is from this sampled lcp on */
+#define BWT_AUTO_LCP 8.0
+/* and the dna sorter on dna_block()s below this one, it compares 32
+   bases at a time */
+#define BWT_DNA_LCP 32.0
+/* ds is given up for sa-is from this sampled lcp on even if asked for,
+   it is quadratic in the lcps of periodic text */
+#define BWT_DS_MAX_LCP 256.0
+
+/* reverse_bwt_lowmem() samples its counts every 1 << BWT_LOWMEM_LOG
+   symbols, 2 bytes per symbol of the alphabet */
+#define BWT_LOWMEM_LOG 9
+
+    /*
+     * tunable deep-shallow parameters, ds_params_default() gives the
+     * values aazip always used. a shallow_limit of 0 means
+     * anchor_dist+50. with autotune, anchor_dist, shallow_limit and
+     * blind_sort_ratio are picked per block from a sample of the text,
+     * those named in set are kept.
+     */
+    typedef struct {
+        int anchor_dist;
+        int shallow_limit;
+        int blind_sort_ratio;
+        int mk_qs_thresh;
+        int b2g_ratio;
+        int word_size;
+        int autotune;
+        int set;        /* DS_SET_* of the fields given explicitly */
+    } ds_params_t;
+
+#define DS_SET_ADIST 0x01
+#define DS_SET_SHALLOW 0x02
+#define DS_SET_BLIND 0x04
+/* largest shallow limit, blind sort and b2g ratio. the shallow limit
+   is padding after every block */
+#define DS_PARAM_MAX (1<<17)
+
+/* autotune sorts this many sampled suffixes, comparing at most
+   DS_TUNE_MAX_LCP chars */
+#define DS_TUNE_SAMPLES 4096
+#define DS_TUNE_MAX_LCP 1024
+/* parameters it picks for repetitive text */
+#define DS_TUNE_ADIST 100
+#define DS_TUNE_SHALLOW 150
+#define DS_TUNE_BLIND 1000
+
+    /* ------- node of blind trie -------- */
+    typedef struct nodex {
+        int32_t skip;
+        uint8_t key;
+        struct nodex*  down;
+        struct nodex* right;
+    } node;
+
+    /* chunk of the blind trie arena */
+    typedef struct node_chunk {
+        node* nodes;
+        int32_t size;
+        struct node_chunk* next;
+    } node_chunk_t;
+
+    /*
+     * state of one deep-shallow suffix sort. everything the sorting
+     * routines used to share through file-scope globals lives here, so
+     * each thread can run its own bwt by owning a separate context.
+     */
+    typedef struct {
+        /* parameters requested by the caller, copied into the fields
+           below by ds_ssort_prepare() */
+        ds_params_t Params;
+
+        /* parameters (see init_ds_ssort) */
+        int Anchor_dist;
+        int Shallow_limit;
+        int _ds_Verbose;
+        int _ds_Word_size;
+        int Mk_qs_thresh;
+        int32_t Max_pseudo_anchor_offset;
+        int32_t B2g_ratio;
+        int32_t Update_anchor_ranks;
+        int32_t Blind_sort_ratio;
+
+        /* text and suffix array currently being sorted */
+        uint8_t* Text;
+        int32_t Text_size;
+        uint8_t* Upper_text_limit;
+        uint8_t* Shallow_text_limit;
+        int32_t* Sa;
+        int32_t* ftab;  /* 65537 entries, shared with the workers */
+        int32_t runningOrder[256];
+
+        /* anchors */
+        int32_t Anchor_num;
+        int32_t* Anchor_rank;
+        uint16_t* Anchor_offset;
+        uint8_t bucket_ranked[65536];
+        int32_t* Anchor_buf;
+        int32_t Anchor_buf_size;
+
+        /* the small buckets of a big bucket are sorted on Pool if it is
+           set. the workers log their anchor updates instead (see
+           set_anchor) */
+        pool_t* Pool;
+        int Anchor_defer;
+        int32_t* Anchor_log;
+        int32_t Anchor_log_num;
+        int32_t Anchor_log_size;
+
+        /* keys cached by shallow_mkq64 */
+        uint64_t* Mkq_keys;
+        int32_t Mkq_keys_size;
+
+        /* blind trie. the nodes come from an arena of chunks which is
+           rewound after every blind_ssort and kept for the next */
+        node_chunk_t* Node_chunks;
+        node_chunk_t* Node_cur;
+        int32_t Node_used;
+        int32_t* Aux;
+        int32_t Aux_written;
+        node** Stack;
+        int Stack_size;
+        int32_t Stack_cap;
+
+        /* comparison results of the unrolled lcp routines */
+        lcp_simd_t Simd;
+        int32_t Cmp_done;
+        int32_t Cmp_left;
+        int lcp_aux[1+Max_thresh];
+
+        /* statistics */
+        int32_t Calls_helped_sort;
+        int32_t Calls_anchor_sort_forw;
+        int32_t Calls_anchor_sort_backw;
+        int32_t Calls_pseudo_anchor_sort_forw;
+        int32_t Calls_deep_sort;
+    } ds_ctx_t;
+
+    ds_ctx_t* ds_ctx_create(void);
+    void ds_ctx_free(ds_ctx_t* ctx);
+
+    uint8_t* transform_bwt(ds_ctx_t* ctx,bwt_sorter_t sorter,uint8_t* input,int64_t n,
+                           uint8_t* out,int64_t* I);
+    uint8_t* reverse_bwt(uint8_t* in,int64_t n,int64_t I,uint8_t* out);
+    uint8_t* transform_bwt_sampled(ds_ctx_t* ctx,bwt_sorter_t* sorter,uint8_t* input,
+                                   int64_t n,uint8_t* out,int64_t* idx,int32_t k,
+                                   int64_t pad);
+    int32_t bwt_padding(ds_ctx_t* ctx);
+    uint8_t* reverse_bwt_sampled(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out);
+    uint64_t reverse_bwt_space(int64_t n);
+    uint8_t* reverse_bwt_lowmem(uint8_t* in,int64_t n,int64_t* idx,int32_t k,uint8_t* out);
+    uint64_t reverse_bwt_lowmem_space(int64_t n);
+    int64_t bwt_index_step(int64_t n,int32_t k);
+    bwt_sorter_t bwt_choose_sorter(const uint8_t* t,int64_t n);
+    bwt_sorter_t bwt_fit_sorter(const uint8_t* t,int64_t n,bwt_sorter_t sorter);
+    int32_t bwt_num_index(int64_t n);
+
+
+    void helped_sort(ds_ctx_t* ctx,int32_t* a, int32_t n, int32_t depth);
+    void shallow_inssort_lcp(ds_ctx_t* ctx,int32_t* a, int32_t n, uint8_t* text_depth);
+
+    void shallow_mkq(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth);
+    void shallow_mkq16(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth);
+    void shallow_mkq32(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth);
+    void shallow_mkq64(ds_ctx_t* ctx,int32_t* a, int n, uint8_t* text_depth);
+
+    void ds_ssort(ds_ctx_t* ctx,uint8_t* t, int32_t* sa, int32_t n);
+    int init_ds_ssort(ds_ctx_t* ctx,int adist, int bs_ratio);
+    void ds_params_default(ds_params_t* p);
+    void ds_ctx_set_params(ds_ctx_t* ctx,const ds_params_t* p);
+    int ds_params_check(const ds_params_t* p);
+    int ds_ssort_prepare(ds_ctx_t* ctx,const uint8_t* t,int32_t n);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBBWT_H */
+
@@ -0,0 +1,669 @@
+/*
+ * File:   libdna.c
+ * Author: Matthias Petri
+ *
+ * suffix sorting of nucleotide sequences. the bases A, C, G and T are
+ * packed into 2 bits each, in the order of their byte values, so 32
+ * of them compare as one 64 bit word. any other symbol (N, the
+ * newlines of a fasta file, lower case bases) is an exception: it is
+ * packed as A, flagged in a bit vector and kept in sorted lists of
+ * runs of the same symbol and of stretches of exceptions.
+ * the suffixes starting with a base are bucketed on their first
+ * DNA_PREFIX bases (16 bits) and each bucket is sorted on 32 base
+ * words, by an msd radix sort on their bytes down to DNA_RADIX
+ * suffixes and a multikey quicksort below that, which falls back to
+ * the bytes where an exception shows up. a run of the same exception
+ * is skipped in one step there. the suffixes starting with an
+ * exception are ranked by sa-is on the stretches, see
+ * dna_sort_exceptions(), so the runs of N of a fasta file cost no
+ * deep comparisons. a group sharing DNA_MAX_DEPTH symbols makes it give
+ * up, a repeat that long costs every suffix in it a comparison per
+ * word of the repeat, sa-is does not slow down on it.
+ */
+
+#include "libdna.h"
+#include "libsais.h"
+
+#if defined(__GNUC__)
+#define DNA_CTZ(x) __builtin_ctzll(x)
+#define DNA_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define DNA_PREFETCH(p) ((void) 0)
+static int32_t
+dna_ctz(uint64_t x)
+{
+    int32_t i = 0;
+
+    while (!(x & 1)) {
+        x >>= 1;
+        i++;
+    }
+    return i;
+}
+#define DNA_CTZ(x) dna_ctz(x)
+#endif
+
+typedef struct {
+    const uint8_t* t;
+    int32_t n;
+    uint64_t* pack;     /* base i in the bits 63-2*(i%32) and below of pack[i/32] */
+    uint64_t* exc;      /* bit i%64 of exc[i/64] is set for exceptions */
+    int32_t* run_pos;   /* runs of the same exception, by position */
+    int32_t* run_end;
+    int32_t nruns, runs_cap;
+    int32_t* str_pos;   /* stretches of exceptions, by position */
+    int32_t* str_end;
+    int32_t nstr, str_cap;
+} dna_text_t;
+
+#define DNA_IS_EXC(s,i) (((s)->exc[(i) >> 6] >> ((i) & 63)) & 1)
+
+/* group a[0..m-1] sharing their first d symbols */
+typedef struct {
+    int32_t* a;
+    int32_t m, d;
+} dna_frame_t;
+
+/* state of one sorting thread */
+typedef struct {
+    const dna_text_t* s;
+    dna_frame_t* stack;
+    int32_t top, cap;
+    uint64_t* keys;     /* of the group dna_radix() sorts */
+    int32_t* tags;
+    uint64_t* keys2;    /* and where it distributes them to */
+    int32_t* tags2;
+    int32_t* a2;
+    int32_t keys_size;
+    int deep;           /* a group reached DNA_MAX_DEPTH */
+} dna_sorter_t;
+
+/* the 32 bases from position a on, the first in the top bits */
+static uint64_t
+dna_word(const dna_text_t* s,int64_t a)
+{
+    int64_t q = a >> 5;
+    int32_t r = (int32_t) (a & 31);
+    uint64_t w = s->pack[q] << (2*r);
+
+    if (r) w |= s->pack[q+1] >> (64 - 2*r);
+    return w;
+}
+
+/* exception flags of the 64 positions from a on, the first in bit 0 */
+static uint64_t
+dna_exc(const dna_text_t* s,int64_t a)
+{
+    int64_t q = a >> 6;
+    int32_t r = (int32_t) (a & 63);
+    uint64_t e = s->exc[q] >> r;
+
+    if (r) e |= s->exc[q+1] << (64 - r);
+    return e;
+}
+
+/* length of the run of exceptions left at position a, which is one.
+   most are single newlines, those are not looked up */
+static int32_t
+dna_run_left(const dna_text_t* s,int32_t a)
+{
+    int32_t lo = 0, hi = s->nruns - 1, mid;
+
+    if (a + 1 == s->n || s->t[a+1] != s->t[a]) return 1;
+    while (lo < hi) {
+        mid = lo + (hi - lo + 1)/2;
+        if (s->run_pos[mid] <= a) lo = mid;
+        else hi = mid - 1;
+    }
+    return s->run_end[lo] - a;
+}
+
+/* compare the suffixes at i and j, which share their first d symbols.
+   0 with w->deep set if they share DNA_MAX_DEPTH, a skipped run counts
+   as one symbol there */
+static int
+dna_cmp(dna_sorter_t* w,int32_t i,int32_t j,int32_t d)
+{
+    const dna_text_t* s = w->s;
+    int64_t a, b;
+    int32_t l, depth = d;
+    uint64_t e, x, y;
+
+    for (;;) {
+        if (depth >= DNA_MAX_DEPTH) {
+            w->deep = 1;
+            return 0;
+        }
+        a = (int64_t) i + d;
+        b = (int64_t) j + d;
+        if (a >= s->n) return -1;
+        if (b >= s->n) return 1;
+        l = (int32_t) MIN(DNA_WORD,s->n - MAX(a,b));
+        e = s->nruns ? (dna_exc(s,a) | dna_exc(s,b)) & (((uint64_t) 1 << l) - 1) : 0;
+        if (e & 1) {
+            if (s->t[a] != s->t[b]) return s->t[a] < s->t[b] ? -1 : 1;
+            d += MIN(dna_run_left(s,(int32_t) a),dna_run_left(s,(int32_t) b));
+            depth++;
+            continue;
+        }
+        if (e) l = DNA_CTZ(e);
+        x = dna_word(s,a);
+        y = dna_word(s,b);
+        if (l < DNA_WORD) {
+            x >>= 64 - 2*l;
+            y >>= 64 - 2*l;
+        }
+        if (x != y) return x < y ? -1 : 1;
+        d += l;
+        depth += l;
+    }
+}
+
+/* ****************************************************************
+   key of the suffix at i for the word at depth d, and a tag ordering
+   equal keys. a full word of bases is its own key with the tag
+   DNA_TAG_BASES. otherwise the word is cut at the first exception or
+   the end of the text, at offset l, and the key and tag place it among
+   the full words: below those with the same first l bases if the
+   symbol there is smaller than A (or the end), else right above those
+   continuing with the largest base below it. equal keys and tags other
+   than DNA_TAG_BASES share d+l+1 symbols
+   **************************************************************** */
+#define DNA_TAG_BASES (DNA_WORD*257)
+
+static uint64_t
+dna_key(const dna_text_t* s,int32_t i,int32_t d,int32_t* tag)
+{
+    int64_t a = (int64_t) i + d;
+    uint64_t w, e;
+    int32_t l, x, c;
+
+    w = dna_word(s,a);
+    e = s->nruns ? (uint32_t) dna_exc(s,a) : 0;
+    l = (int32_t) MIN(DNA_WORD,s->n - a);
+    if (e) l = MIN(l,DNA_CTZ(e));
+    if (l == DNA_WORD) {
+        *tag = DNA_TAG_BASES;
+        return w;
+    }
+    /* symbol after the cut plus one, 0 for the end */
+    x = (a + l < s->n) ? s->t[a+l] + 1 : 0;
+    c = (x > 'A'+1) + (x > 'C'+1) + (x > 'G'+1) + (x > 'T'+1);
+    w = l ? (w >> (64 - 2*l)) << (64 - 2*l) : 0;
+    if (c == 0) {
+        *tag = l*257 + x;
+        return w;
+    }
+    w |= ((uint64_t) (c-1) << (62 - 2*l)) | (((uint64_t) 1 << (62 - 2*l)) - 1);
+    *tag = DNA_TAG_BASES + 1 + (DNA_WORD-1 - l)*257 + x;
+    return w;
+}
+
+/* offset of the cut of a tag other than DNA_TAG_BASES */
+#define DNA_TAG_CUT(t) ((t) < DNA_TAG_BASES ? (t)/257 : DNA_WORD-1 - ((t) - DNA_TAG_BASES - 1)/257)
+
+static void
+dna_inssort(dna_sorter_t* w,int32_t* a,int32_t m,int32_t d)
+{
+    int32_t i, j, x;
+
+    for (i = 1; i < m; i++) {
+        x = a[i];
+        for (j = i; j > 0 && dna_cmp(w,a[j-1],x,d) > 0; j--) a[j] = a[j-1];
+        a[j] = x;
+    }
+}
+
+static void
+dna_push(dna_sorter_t* w,int32_t* a,int32_t m,int32_t d)
+{
+    if (d >= DNA_MAX_DEPTH) {
+        w->deep = 1;
+        return;
+    }
+    if (w->top == w->cap) {
+        w->cap = MAX(64,2*w->cap);
+        w->stack = (dna_frame_t*) safe_realloc(w->stack,w->cap*sizeof(dna_frame_t));
+    }
+    w->stack[w->top].a = a;
+    w->stack[w->top].m = m;
+    w->stack[w->top].d = d;
+    w->top++;
+}
+
+#define DNA_SWAP(x,y) do { int32_t _t = (x); (x) = (y); (y) = _t; } while (0)
+#define DNA_LESS(k,t,vk,vt) ((k) < (vk) || ((k) == (vk) && (t) < (vt)))
+
+/* depth of a group of equal keys and tags t at depth d */
+#define DNA_NEXT(d,t) ((d) + ((t) == DNA_TAG_BASES ? DNA_WORD : DNA_TAG_CUT(t)+1))
+
+/* insertion sort of a[0..m-1] by the keys k and tags tg, the ties
+   are compared past them */
+static void
+dna_inssort_keys(dna_sorter_t* w,int32_t* a,uint64_t* k,int32_t* tg,int32_t m,int32_t d)
+{
+    int32_t i, j, x, tx;
+    uint64_t kx;
+
+    for (i = 1; i < m; i++) {
+        x = a[i];
+        kx = k[i];
+        tx = tg[i];
+        for (j = i; j > 0; j--) {
+            if (!DNA_LESS(kx,tx,k[j-1],tg[j-1]) &&
+                (k[j-1] != kx || tg[j-1] != tx || dna_cmp(w,a[j-1],x,DNA_NEXT(d,tx)) < 0))
+                break;
+            a[j] = a[j-1];
+            k[j] = k[j-1];
+            tg[j] = tg[j-1];
+        }
+        a[j] = x;
+        k[j] = kx;
+        tg[j] = tx;
+    }
+}
+
+/* ****************************************************************
+   ternary quicksort of a[0..m-1] on the keys k and tags tg of the
+   word at depth d, which are filled once per group like the cached
+   keys of shallow_mkq64(). the groups of equal keys and tags are
+   pushed for the depth past them
+   **************************************************************** */
+static void
+dna_mkq(dna_sorter_t* w,int32_t* a,uint64_t* k,int32_t* tg,int32_t m,int32_t d)
+{
+    uint64_t v, x;
+    int32_t vt, lt, i, gt, p0, p1, p2;
+
+    while (m > DNA_INSSORT) {
+        /* median of three */
+        p0 = 0;
+        p1 = m/2;
+        p2 = m-1;
+        if (DNA_LESS(k[p2],tg[p2],k[p0],tg[p0])) {
+            p0 = m-1;
+            p2 = 0;
+        }
+        if (DNA_LESS(k[p1],tg[p1],k[p0],tg[p0])) p1 = p0;
+        else if (DNA_LESS(k[p2],tg[p2],k[p1],tg[p1])) p1 = p2;
+        v = k[p1];
+        vt = tg[p1];
+
+        lt = i = 0;
+        gt = m;
+        while (i < gt) {
+            if (DNA_LESS(k[i],tg[i],v,vt)) {
+                DNA_SWAP(a[lt],a[i]);
+                DNA_SWAP(tg[lt],tg[i]);
+                x = k[lt]; k[lt] = k[i]; k[i] = x;
+                lt++;
+                i++;
+            } else if (DNA_LESS(v,vt,k[i],tg[i])) {
+                gt--;
+                DNA_SWAP(a[i],a[gt]);
+                DNA_SWAP(tg[i],tg[gt]);
+                x = k[gt]; k[gt] = k[i]; k[i] = x;
+            } else i++;
+        }
+        if (gt - lt > 1) dna_push(w,a+lt,gt-lt,DNA_NEXT(d,vt));
+        if (lt < m - gt) {
+            dna_mkq(w,a,k,tg,lt,d);
+            a += gt;
+            k += gt;
+            tg += gt;
+            m -= gt;
+        } else {
+            dna_mkq(w,a+gt,k+gt,tg+gt,m-gt,d);
+            m = lt;
+        }
+    }
+    dna_inssort_keys(w,a,k,tg,m,d);
+}
+
+/* ****************************************************************
+   msd radix sort of a[0..m-1] on the byte of the keys at bit sh, the
+   bits above it are equal. a byte all keys share is skipped, groups
+   of equal keys are left to dna_mkq() for their tags
+   **************************************************************** */
+static void
+dna_radix(dna_sorter_t* w,int32_t* a,uint64_t* k,int32_t* tg,int32_t m,int32_t d,int32_t sh)
+{
+    int32_t cnt[257], i, j, c;
+
+    for (; sh >= 0 && m > DNA_RADIX; sh -= 8) {
+        memset(cnt,0,sizeof(cnt));
+        for (i = 0; i < m; i++) cnt[((k[i] >> sh) & 0xff) + 1]++;
+        if (cnt[((k[0] >> sh) & 0xff) + 1] == m) continue;
+        for (c = 1; c <= 256; c++) cnt[c] += cnt[c-1];
+        for (i = 0; i < m; i++) {
+            j = cnt[(k[i] >> sh) & 0xff]++;
+            w->a2[j] = a[i];
+            w->keys2[j] = k[i];
+            w->tags2[j] = tg[i];
+        }
+        memcpy(a,w->a2,m*sizeof(int32_t));
+        memcpy(k,w->keys2,m*sizeof(uint64_t));
+        memcpy(tg,w->tags2,m*sizeof(int32_t));
+        /* cnt[c] is now the end of byte c */
+        for (c = 0, i = 0; c < 256; i = cnt[c++])
+            if (cnt[c] - i > 1) dna_radix(w,a+i,k+i,tg+i,cnt[c]-i,d,sh-8);
+        return;
+    }
+    dna_mkq(w,a,k,tg,m,d);
+}
+
+/* ****************************************************************
+   sort the group a[0..m-1] sharing d symbols. the groups are kept on
+   a stack instead of recursing, a long repeat makes a chain of them.
+   stops once a group reaches DNA_MAX_DEPTH
+   **************************************************************** */
+static void
+dna_sort_group(dna_sorter_t* w,int32_t* a,int32_t m,int32_t d)
+{
+    dna_frame_t f;
+    int32_t i;
+
+    dna_push(w,a,m,d);
+    while (w->top > 0 && !w->deep) {
+        f = w->stack[--w->top];
+        if (f.m <= DNA_INSSORT) {
+            dna_inssort(w,f.a,f.m,f.d);
+            continue;
+        }
+        if (f.m > w->keys_size) {
+            w->keys_size = MAX(f.m,2*w->keys_size);
+            w->keys = (uint64_t*) safe_realloc(w->keys,w->keys_size*sizeof(uint64_t));
+            w->tags = (int32_t*) safe_realloc(w->tags,w->keys_size*sizeof(int32_t));
+            w->keys2 = (uint64_t*) safe_realloc(w->keys2,w->keys_size*sizeof(uint64_t));
+            w->tags2 = (int32_t*) safe_realloc(w->tags2,w->keys_size*sizeof(int32_t));
+            w->a2 = (int32_t*) safe_realloc(w->a2,w->keys_size*sizeof(int32_t));
+        }
+        /* the words are read DNA_PREFETCH_DIST suffixes ahead */
+        for (i = 0; i < f.m; i++) {
+            if (i + DNA_PREFETCH_DIST < f.m) {
+                DNA_PREFETCH(w->s->pack + (((int64_t) f.a[i+DNA_PREFETCH_DIST] + f.d) >> 5));
+                if (w->s->nruns)
+                    DNA_PREFETCH(w->s->exc + (((int64_t) f.a[i+DNA_PREFETCH_DIST] + f.d) >> 6));
+            }
+            w->keys[i] = dna_key(w->s,f.a[i],f.d,&w->tags[i]);
+        }
+        /* the first DNA_PREFIX bases of a bucket are equal */
+        dna_radix(w,f.a,w->keys,w->tags,f.m,f.d,f.d ? 56 : 56 - 2*DNA_PREFIX);
+    }
+}
+
+static void
+dna_sorter_free(dna_sorter_t* w)
+{
+    free(w->stack);
+    free(w->keys);
+    free(w->tags);
+    free(w->keys2);
+    free(w->tags2);
+    free(w->a2);
+}
+
+/* append the range [i,i+1) to pos/end */
+static void
+dna_new_range(int32_t** pos,int32_t** end,int32_t* num,int32_t* cap,int32_t i)
+{
+    if (*num == *cap) {
+        *cap = MAX(REALLOC_INCREMENT,2*(*cap));
+        *pos = (int32_t*) safe_realloc(*pos,(*cap)*sizeof(int32_t));
+        *end = (int32_t*) safe_realloc(*end,(*cap)*sizeof(int32_t));
+    }
+    (*pos)[*num] = i;
+    (*end)[*num] = i+1;
+    (*num)++;
+}
+
+/* pack t[0..n-1] and collect its exceptions */
+static void
+dna_pack(dna_text_t* s,const uint8_t* t,int32_t n)
+{
+    int8_t code[256];
+    int32_t i;
+
+    memset(code,-1,sizeof(code));
+    code['A'] = 0;
+    code['C'] = 1;
+    code['G'] = 2;
+    code['T'] = 3;
+
+    memset(s,0,sizeof(dna_text_t));
+    s->t = t;
+    s->n = n;
+    s->pack = (uint64_t*) safe_malloc_large(((size_t) (n >> 5) + 2)*sizeof(uint64_t));
+    s->exc = (uint64_t*) safe_malloc(((size_t) (n >> 6) + 2)*sizeof(uint64_t));
+    for (i = 0; i < n; i++) {
+        if (code[t[i]] >= 0) {
+            s->pack[i >> 5] |= (uint64_t) code[t[i]] << (62 - 2*(i & 31));
+            continue;
+        }
+        s->exc[i >> 6] |= (uint64_t) 1 << (i & 63);
+        if (s->nstr > 0 && s->str_end[s->nstr-1] == i) s->str_end[s->nstr-1]++;
+        else dna_new_range(&s->str_pos,&s->str_end,&s->nstr,&s->str_cap,i);
+        if (s->nruns > 0 && s->run_end[s->nruns-1] == i && t[i-1] == t[i]) s->run_end[s->nruns-1]++;
+        else dna_new_range(&s->run_pos,&s->run_end,&s->nruns,&s->runs_cap,i);
+    }
+}
+
+static void
+dna_text_free(dna_text_t* s)
+{
+    free(s->run_pos);
+    free(s->run_end);
+    free(s->str_pos);
+    free(s->str_end);
+    free(s->exc);
+    free_large(s->pack);
+}
+
+/* a run of buckets [blo, bhi) sorted on the pool */
+typedef struct {
+    pool_task_t task;
+    const dna_text_t* s;
+    int32_t* sa;
+    const int32_t* ftab;
+    int32_t blo, bhi;
+    int deep;
+} dna_task_t;
+
+/* sort the buckets [blo, bhi), 0 if one of them is too deep */
+static int
+dna_sort_buckets(const dna_text_t* s,int32_t* sa,const int32_t* ftab,int32_t blo,int32_t bhi)
+{
+    dna_sorter_t w;
+    int32_t b;
+
+    memset(&w,0,sizeof(w));
+    w.s = s;
+    for (b = blo; b < bhi && !w.deep; b++)
+        if (ftab[b+1] - ftab[b] > 1) dna_sort_group(&w,sa+ftab[b],ftab[b+1]-ftab[b],0);
+    dna_sorter_free(&w);
+    return !w.deep;
+}
+
+static void
+dna_task(void* arg,int worker)
+{
+    dna_task_t* t = (dna_task_t*) arg;
+
+    (void) worker;
+    t->deep = !dna_sort_buckets(t->s,t->sa,t->ftab,t->blo,t->bhi);
+}
+
+/* ****************************************************************
+   is t[0..n-1] worth sorting with dna_ssort()
+   **************************************************************** */
+int
+dna_block(const uint8_t* t,int64_t n)
+{
+    int64_t i, bases = 0, runs = 0;
+    uint8_t c;
+
+    for (i = 0; i < n; i++) {
+        c = t[i];
+        if (DNA_IS_BASE(c)) bases++;
+        else if (i == 0 || t[i-1] != c) runs++;
+    }
+    return bases >= n/2 && runs <= n/DNA_RUN_RATIO;
+}
+
+/* ****************************************************************
+   can t[0..n-1] be dna at all: are at least half of DNA_PROBE_SAMPLES
+   evenly spaced bytes bases. cheap enough to run on every block
+   **************************************************************** */
+int
+dna_probe(const uint8_t* t,int64_t n)
+{
+    int64_t i, step, bases = 0, cnt = 0;
+
+    step = MAX(n/DNA_PROBE_SAMPLES,1);
+    for (i = 0; i < n; i += step, cnt++)
+        if (DNA_IS_BASE(t[i])) bases++;
+    return bases >= cnt/2 && cnt > 0;
+}
+
+/* the stretch of exceptions ending at e */
+static int32_t
+dna_stretch(const dna_text_t* s,int32_t e)
+{
+    int32_t lo = 0, hi = s->nstr - 1, mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo)/2;
+        if (s->str_end[mid] < e) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+/* ****************************************************************
+   sort the suffixes starting with an exception and merge them with the
+   nb sorted ones starting with a base in sa[0..nb-1]. the stretch of
+   exceptions t[p..e-1] is followed by the suffix at e, which starts
+   with a base (or is empty), so the suffixes in it are ordered by
+   their tail of the stretch and then by the suffix at e. the
+   stretches are written as integers, each followed by a terminator
+   which takes the place of t[e] among the symbols and is ranked like
+   the suffix at e, and sorted together with sais_isort(). the two
+   sets of suffixes differ in the first symbol, so they are merged on
+   that alone
+   **************************************************************** */
+static void
+dna_sort_exceptions(const dna_text_t* s,int32_t* sa,int32_t nb)
+{
+    int32_t sym[ALPHABET_SIZE], cnt[ALPHABET_SIZE];
+    int32_t* term, *r, *rsa;
+    int32_t i, j, k, b, m, id, nx;
+
+    /* symbol ids in byte order, the terminators in the places of the
+       bases in the order of the suffixes following them. the end of
+       the text is 0 */
+    term = (int32_t*) safe_malloc(s->nstr*sizeof(int32_t));
+    for (b = 0, j = 0, id = 1; b < ALPHABET_SIZE; b++) {
+        if (DNA_IS_BASE(b)) {
+            for (; j < nb && s->t[sa[j]] == b; j++) {
+                i = sa[j];
+                if (i > 0 && DNA_IS_EXC(s,i-1)) term[dna_stretch(s,i)] = id++;
+            }
+        } else sym[b] = id++;
+    }
+
+    nx = s->n - nb;
+    r = (int32_t*) safe_malloc((nx + s->nstr)*sizeof(int32_t));
+    rsa = (int32_t*) safe_malloc((nx + s->nstr)*sizeof(int32_t));
+    for (k = 0, m = 0; k < s->nstr; k++) {
+        for (i = s->str_pos[k]; i < s->str_end[k]; i++) r[m++] = sym[s->t[i]];
+        r[m++] = (s->str_end[k] == s->n) ? 0 : term[k];
+    }
+    sais_isort(r,rsa,m,id);
+
+    /* back to text positions, dropping the terminators */
+    for (k = 0, m = 0; k < s->nstr; k++) {
+        for (i = s->str_pos[k]; i < s->str_end[k]; i++) r[m++] = i;
+        r[m++] = -1;
+    }
+    for (i = 0, j = 0; i < m; i++)
+        if (r[rsa[i]] >= 0) rsa[j++] = r[rsa[i]];
+
+    /* merge on the first symbol, from the back. both sets are in order
+       of it, so each symbol moves as one block */
+    memset(cnt,0,sizeof(cnt));
+    for (i = 0; i < s->n; i++) cnt[s->t[i]]++;
+    for (b = ALPHABET_SIZE-1, i = nb, j = nx, k = s->n; b >= 0; b--) {
+        k -= cnt[b];
+        if (DNA_IS_BASE(b)) {
+            i -= cnt[b];
+            memmove(sa+k,sa+i,cnt[b]*sizeof(int32_t));
+        } else {
+            j -= cnt[b];
+            memcpy(sa+k,rsa+j,cnt[b]*sizeof(int32_t));
+        }
+    }
+
+    free(rsa);
+    free(r);
+    free(term);
+}
+
+/* ****************************************************************
+   suffix array of t[0..n-1] in sa. any text is sorted correctly, but
+   it is slower than ds_ssort() on text that is not mostly bases, see
+   dna_block(). the suffixes starting with a base are bucketed into
+   sa on the first DNA_PREFIX bases of their key, which is read in
+   text order here. with a pool the buckets are sorted in parallel.
+   returns 0, with sa undefined, if suffixes share DNA_MAX_DEPTH
+   symbols
+   **************************************************************** */
+int
+dna_ssort(const uint8_t* t,int32_t* sa,int32_t n,pool_t* pool)
+{
+    dna_text_t s;
+    dna_task_t* tasks;
+    int32_t* ftab;
+    int32_t i, b, nb, ntasks, tag, ok;
+
+    if (n < 2) {
+        if (n == 1) sa[0] = 0;
+        return 1;
+    }
+    dna_pack(&s,t,n);
+
+    ftab = (int32_t*) safe_malloc((DNA_BUCKETS+1)*sizeof(int32_t));
+    for (i = 0; i < n; i++)
+        if (!DNA_IS_EXC(&s,i)) ftab[(dna_key(&s,i,0,&tag) >> (64 - 2*DNA_PREFIX)) + 1]++;
+    for (b = 1; b <= DNA_BUCKETS; b++) ftab[b] += ftab[b-1];
+    nb = ftab[DNA_BUCKETS];
+    for (i = 0; i < n; i++)
+        if (!DNA_IS_EXC(&s,i)) sa[ftab[dna_key(&s,i,0,&tag) >> (64 - 2*DNA_PREFIX)]++] = i;
+    /* ftab[b] is now the end of bucket b, shift it back to the start */
+    memmove(ftab+1,ftab,DNA_BUCKETS*sizeof(int32_t));
+    ftab[0] = 0;
+
+    if (pool != NULL && nb > DNA_TASK_SIZE) {
+        tasks = (dna_task_t*) safe_malloc((nb/DNA_TASK_SIZE + 1)*sizeof(dna_task_t));
+        for (b = 0, ntasks = 0; b < DNA_BUCKETS; ntasks++) {
+            tasks[ntasks].s = &s;
+            tasks[ntasks].sa = sa;
+            tasks[ntasks].ftab = ftab;
+            tasks[ntasks].blo = b;
+            while (b < DNA_BUCKETS && ftab[b] - ftab[tasks[ntasks].blo] < DNA_TASK_SIZE) b++;
+            tasks[ntasks].bhi = b;
+            pool_submit(pool,&tasks[ntasks].task,dna_task,&tasks[ntasks]);
+        }
+        ok = 1;
+        for (i = 0; i < ntasks; i++) {
+            pool_task_wait(pool,&tasks[i].task);
+            if (tasks[i].deep) ok = 0;
+        }
+        free(tasks);
+    } else ok = dna_sort_buckets(&s,sa,ftab,0,DNA_BUCKETS);
+
+    if (ok && nb < n) dna_sort_exceptions(&s,sa,nb);
+
+    free(ftab);
+    dna_text_free(&s);
+    return ok;
+}
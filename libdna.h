@@ -0,0 +1,54 @@
+/*
+ * File:   libdna.h
+ * Author: Matthias Petri
+ *
+ * suffix sorting of nucleotide sequences on a packed 2 bit alphabet
+ */
+
+#ifndef LIBDNA_H
+#define	LIBDNA_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+#include "libpool.h"
+
+/* a block counts as dna if at least half of it are the bases A, C, G
+   and T and the other symbols form at most one run per DNA_RUN_RATIO
+   bytes. runs of N pass, but each run cuts the words it falls into,
+   so the newlines of a fasta file are removed first, see libwrap.c */
+#define DNA_RUN_RATIO 1024
+/* dna_probe() looks at this many evenly spaced bytes */
+#define DNA_PROBE_SAMPLES 4096
+/* bases compared as one 64 bit word */
+#define DNA_WORD 32
+/* the suffixes are bucketed on their first DNA_PREFIX bases */
+#define DNA_PREFIX 8
+#define DNA_BUCKETS (1 << (2*DNA_PREFIX))
+/* groups of at most this many suffixes are insertion sorted, larger
+   ones read the words of their suffixes DNA_PREFETCH_DIST ahead. down
+   to DNA_RADIX suffixes they are radix sorted on the bytes of the
+   words, below it quicksorted */
+#define DNA_INSSORT 8
+#define DNA_RADIX 64
+#define DNA_PREFETCH_DIST 16
+/* dna_ssort() gives up on groups sharing this many symbols, the
+   block goes to sa-is instead */
+#define DNA_MAX_DEPTH 4096
+/* with a pool, the buckets are sorted in tasks of about this many
+   suffixes */
+#define DNA_TASK_SIZE (64*1024)
+
+#define DNA_IS_BASE(c) ((c) == 'A' || (c) == 'C' || (c) == 'G' || (c) == 'T')
+
+    int dna_block(const uint8_t* t,int64_t n);
+    int dna_probe(const uint8_t* t,int64_t n);
+    int dna_ssort(const uint8_t* t,int32_t* sa,int32_t n,pool_t* pool);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBDNA_H */
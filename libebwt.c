@@ -0,0 +1,410 @@
+/*
+ * File:   libebwt.c
+ * Author: Matthias Petri
+ *
+ * external memory bwt following Ferragina, Gagie and Manzini,
+ * "Lightweight Data Indexing and Compression in External Memory".
+ * the text is split into blocks of b symbols which are added right to
+ * left to the bwt of the already processed suffix of the text (the
+ * tail). for every block we
+ *
+ *  1. sort the suffixes starting in the block in memory. suffixes that
+ *     share a prefix of b symbols are ordered by the tail suffixes b
+ *     positions later, whose ranks were computed for the previous block.
+ *  2. scan the tail backwards and compute for every tail suffix the
+ *     number of block suffixes smaller than it by backward search over
+ *     the bwt of the block. this gives the gap array: how many tail
+ *     suffixes go before each block suffix.
+ *  3. merge the bwt of the block into the tail bwt in one pass.
+ *
+ * besides reading the text (typically a mapped file) block by block
+ * and backwards, all i/o is sequential reads and writes of temporary
+ * files. memory is about EBWT_SPACE bytes per block symbol. the total
+ * work is O(n^2/b), so a larger budget pays off directly.
+ *
+ * the archive is one block of the whole file, which the decoder inverts
+ * in memory: reverse_bwt_sampled() takes 4 bytes per symbol besides
+ * the bwt and the text, 8 from PSI_MAX_32 symbols on, which is
+ * reverse_bwt64(). given -e, aazip -d uses reverse_bwt_lowmem() when
+ * that does not fit, about one byte per symbol, and refuses the
+ * archive when not even that fits.
+ */
+
+#include "libutil.h"
+#include "libbwt.h"
+#include "libsais.h"
+#include "librank.h"
+#include "libebwt.h"
+
+/* occ() counts sampled every 1 << OCC_LOG symbols, 8 bytes per symbol */
+#define OCC_LOG 6
+#define GROUP_MASK (1 << 30)
+/* bytes buffered by the greater-than bit streams */
+#define GT_BUF (64*1024)
+
+/* the greater-than bits of the tail, a temporary file read and written
+   a buffer at a time */
+typedef struct {
+    FILE* f;
+    uint8_t* buf;
+    int32_t len,pos,bit;
+} gt_bits_t;
+
+typedef struct {
+    const uint8_t* t;
+    int64_t n;
+    int64_t ts;         /* the tail is t[ts..n) */
+    FILE* bwt;          /* bwt of the tail. row prim holds 0 */
+    int64_t prim;       /* row of the tail suffix t[ts..] */
+    gt_bits_t* gt;      /* for j = n-1 down to ts+1: t[j..] > t[ts..] */
+    int32_t* rank;      /* rank of t[ts+q..] among the suffixes of the
+                           first tail block, q < b */
+    int64_t step;       /* distance of the sampled text positions */
+    int64_t* rows;      /* rows of the sampled positions >= ts */
+} ebwt_t;
+
+static gt_bits_t*
+gt_open(FILE* f)
+{
+    gt_bits_t* g = (gt_bits_t*) safe_malloc(sizeof(gt_bits_t));
+
+    g->f = f;
+    g->buf = (uint8_t*) safe_malloc(GT_BUF);
+    g->len = g->pos = g->bit = 0;
+    return g;
+}
+
+static void
+gt_put(gt_bits_t* g,int v)
+{
+    if (v) g->buf[g->pos] |= (uint8_t) (1 << g->bit);
+    if (++g->bit < 8) return;
+    g->bit = 0;
+    if (++g->pos < GT_BUF) return;
+    if (fwrite(g->buf,1,GT_BUF,g->f) != GT_BUF) fatal("ERROR: writing temporary file.");
+    memset(g->buf,0,GT_BUF);
+    g->pos = 0;
+}
+
+static int
+gt_get(gt_bits_t* g)
+{
+    int v;
+
+    if (g->pos == g->len) {
+        g->len = (int32_t) fread(g->buf,1,GT_BUF,g->f);
+        if (g->len == 0) fatal("ERROR: temporary file truncated.");
+        g->pos = 0;
+    }
+    v = (g->buf[g->pos] >> g->bit) & 1;
+    if (++g->bit == 8) {
+        g->bit = 0;
+        g->pos++;
+    }
+    return v;
+}
+
+/* writes what gt_put() buffered and rewinds the file for gt_get() */
+static void
+gt_flip(gt_bits_t* g)
+{
+    int32_t m = g->pos + (g->bit > 0);
+
+    if (fwrite(g->buf,1,m,g->f) != (size_t) m) fatal("ERROR: writing temporary file.");
+    rewind(g->f);
+    g->len = g->pos = g->bit = 0;
+}
+
+static void
+gt_close(gt_bits_t* g)
+{
+    safe_fclose(g->f);
+    free(g->buf);
+    free(g);
+}
+
+static int
+cmp_uint64(const void* a,const void* b)
+{
+    uint64_t x = *(const uint64_t*) a;
+    uint64_t y = *(const uint64_t*) b;
+
+    return (x > y) - (x < y);
+}
+
+/* order sab[0..m) by the ranks of the tail suffixes b positions later */
+static void
+sort_group(int32_t* sab,int32_t m,const int32_t* rank)
+{
+    uint64_t* key;
+    int32_t i;
+
+    key = (uint64_t*) safe_malloc(m*sizeof(uint64_t));
+    for (i=0; i<m; i++) key[i] = ((uint64_t) rank[sab[i]] << 32) | sab[i];
+    qsort(key,m,sizeof(uint64_t),cmp_uint64);
+    for (i=0; i<m; i++) sab[i] = (int32_t) key[i];
+    free(key);
+}
+
+/*
+ * sort the suffixes of the text starting in t[s..s+b). with a tail of
+ * at most b symbols the suffix array of t[s..n) is exact. otherwise we
+ * sort t[s..s+2b) and reorder the runs of block suffixes with a common
+ * prefix of b symbols, found with the permuted lcp array, by rank.
+ */
+static int32_t*
+sort_block(ebwt_t* e,int64_t s,int32_t b)
+{
+    const uint8_t* y = e->t + s;
+    int64_t nt = e->n - e->ts;
+    int32_t* sa,*sab,*plcp;
+    int32_t i,j,p,q,l,len,prev,first;
+
+    len = (nt <= b) ? b + (int32_t) nt : 2*b;
+    sa = (int32_t*) safe_malloc(len*sizeof(int32_t));
+    sab = (int32_t*) safe_malloc(b*sizeof(int32_t));
+    sais_ssort(y,sa,len);
+
+    if (nt <= b) {
+        for (i=0,j=0; i<len; i++) if (sa[i] < b) sab[j++] = sa[i];
+        free(sa);
+        return sab;
+    }
+
+    /* plcp[p] = lcp of suffix p with the one before it (phi algorithm) */
+    plcp = (int32_t*) safe_malloc(len*sizeof(int32_t));
+    for (i=0; i<len; i++) plcp[sa[i]] = (i == 0) ? -1 : sa[i-1];
+    for (p=0,l=0; p<len; p++) {
+        q = plcp[p];
+        if (q == -1) {
+            plcp[p] = l = 0;
+            continue;
+        }
+        while (p+l < len && q+l < len && y[p+l] == y[q+l]) l++;
+        plcp[p] = l;
+        l = MAX(l-1,0);
+    }
+
+    /* tag block suffixes that continue a run. a run can not contain a
+       suffix starting past the block as those are at most b long */
+    prev = -1;
+    for (i=0,j=0; i<len; i++) {
+        p = sa[i];
+        if (p < b) {
+            if (prev >= 0 && prev < b && plcp[p] >= b) sab[j++] = p | GROUP_MASK;
+            else sab[j++] = p;
+        }
+        prev = p;
+    }
+    free(plcp);
+    free(sa);
+
+    for (i=0; i<b; i=j) {
+        first = i;
+        for (j=i+1; j<b && (sab[j] & GROUP_MASK); j++) sab[j] &= ~GROUP_MASK;
+        if (j - first > 1) sort_group(sab+first,j-first,e->rank);
+    }
+    return sab;
+}
+
+/* occurrences of c in L[0..r), not counting the primary row k0 */
+static int32_t
+occ(const rank_t* occs,int32_t k0,int c,int32_t r)
+{
+    int32_t cnt;
+
+    cnt = (int32_t) rank_get(occs,c,r);
+    if (k0 < r && occs->L[k0] == c) cnt--;
+    return cnt;
+}
+
+/*
+ * scan the tail backwards and count in G[r] the tail suffixes that are
+ * larger than exactly r block suffixes. the greater-than bits of the
+ * tail are extended to the new tail t[s..n) on the way.
+ */
+static int64_t*
+gap_array(ebwt_t* e,int64_t s,int32_t b,const uint8_t* L,int32_t k0,
+          const int32_t* isa,gt_bits_t* ngt)
+{
+    int32_t C[ALPHABET_SIZE];
+    rank_t occs;
+    int64_t* G;
+    int64_t j,smp;
+    int32_t i,c,r,gt,sum;
+    const uint8_t* t = e->t;
+
+    /* C[c] = block suffixes starting with a symbol < c */
+    memset(C,0,sizeof(C));
+    for (i=0; i<b; i++) C[t[s+i]]++;
+    for (c=0,sum=0; c<ALPHABET_SIZE; c++) {
+        r = C[c];
+        C[c] = sum;
+        sum += r;
+    }
+
+    rank_init(&occs,L,b,OCC_LOG);
+
+    G = (int64_t*) safe_malloc((b+1)*sizeof(int64_t));
+    memset(G,0,(b+1)*sizeof(int64_t));
+
+    /* r of the empty suffix is 0, t[ts..] is not smaller than it.
+       smp is the last sampled position up to j */
+    r = 0;
+    gt = 0;
+    smp = ((e->n-1) / e->step) * e->step;
+    for (j=e->n-1; j>=e->ts; j--) {
+        c = t[j];
+        r = C[c] + occ(&occs,k0,c,r) + (c == t[e->ts-1] && gt);
+        G[r]++;
+        if (j == smp) {
+            e->rows[j / e->step] += r;
+            smp -= e->step;
+        }
+        if (ngt) gt_put(ngt,r > isa[0]);
+        if (j > e->ts) gt = gt_get(e->gt);
+    }
+    for (i=b-1; i>0 && ngt; i--) gt_put(ngt,isa[i] > isa[0]);
+
+    rank_free(&occs);
+    return G;
+}
+
+/*
+ * interleave the tail bwt and the block bwt L into the bwt of t[s..n).
+ * with out != NULL this is the final bwt and is written in the layout
+ * of transform_bwt(): t[n-1], then all rows but the primary one.
+ */
+static FILE*
+merge_bwt(ebwt_t* e,int64_t s,int32_t b,const uint8_t* L,int32_t k0,
+          const int32_t* isa,const int64_t* G,FILE* out)
+{
+    FILE* f;
+    int64_t g,row,orow,prim,smp[2];
+    int64_t* samples;
+    int32_t i,kk,ns,c;
+
+    f = out ? out : tmpfile();
+    if (f == NULL) fatal("tmpfile failed.");
+    if (e->bwt) rewind(e->bwt);
+    if (out) putc(e->t[e->n-1],f);
+
+    /* sampled positions of the block ordered by their block row */
+    samples = (int64_t*) safe_malloc((b / e->step + 2)*2*sizeof(int64_t));
+    for (ns=0,g=s+(e->step - s % e->step) % e->step; g<s+b; g+=e->step,ns++) {
+        samples[2*ns] = isa[g-s];
+        samples[2*ns+1] = g / e->step;
+    }
+    for (i=1; i<ns; i++) {
+        smp[0] = samples[2*i];
+        smp[1] = samples[2*i+1];
+        for (kk=i-1; kk>=0 && samples[2*kk] > smp[0]; kk--) {
+            samples[2*kk+2] = samples[2*kk];
+            samples[2*kk+3] = samples[2*kk+1];
+        }
+        samples[2*kk+2] = smp[0];
+        samples[2*kk+3] = smp[1];
+    }
+
+    row = orow = prim = 0;
+    for (kk=0,i=0; kk<=b; kk++) {
+        for (g=0; g<G[kk]; g++,orow++,row++) {
+            c = getc(e->bwt);
+            if (c == EOF) fatal("ERROR: tail bwt truncated.");
+            if (orow == e->prim) c = e->t[e->ts-1];
+            putc(c,f);
+        }
+        if (kk == b) break;
+        if (kk == k0) prim = row;
+        if (kk != k0 || out == NULL) putc(L[kk],f);
+        for (; i<ns && samples[2*i] == kk; i++) e->rows[samples[2*i+1]] = row;
+        row++;
+    }
+    if (ferror(f)) fatal("ERROR: writing bwt.");
+
+    free(samples);
+    e->prim = prim;
+    return f;
+}
+
+/*
+ * bwt of t[0..n-1] written to out as transform_bwt_sampled() would
+ * return it, with the rows of the k sampled positions in idx. uses
+ * about mem bytes of memory besides the text.
+ */
+void transform_bwt_external(const uint8_t* t,int64_t n,FILE* out,
+                            int64_t* idx,int32_t k,uint64_t mem)
+{
+    ebwt_t e;
+    int64_t s,b64,nb;
+    int64_t* G;
+    int32_t* sab,*isa;
+    uint8_t* L;
+    int32_t i,b,k0;
+    gt_bits_t* ngt;
+    FILE* nbwt,*f;
+
+    if (n <= 0) return;
+    if (k < 1 || k > BWT_MAX_INDEX) fatal("invalid number of primary indices %d.",k);
+
+    b64 = MIN(MAX((int64_t)(mem / EBWT_SPACE),EBWT_MIN_BLOCK),EBWT_MAX_BLOCK);
+    b64 = MIN(b64,n);
+    nb = (n + b64 - 1) / b64;
+
+    e.t = t;
+    e.n = n;
+    e.ts = n;
+    e.bwt = NULL;
+    e.prim = -1;
+    e.gt = NULL;
+    e.rank = NULL;
+    e.step = MAX((n + k - 1) / k,1);
+    e.rows = idx;
+    for (i=0; i<k; i++) idx[i] = 0;
+
+    /* blocks start at multiples of b64, the last one may be shorter */
+    while (nb-- > 0) {
+        s = nb * b64;
+        b = (int32_t)(e.ts - s);
+
+        /* 1. sort the block suffixes */
+        sab = sort_block(&e,s,b);
+        free(e.rank);
+
+        /* bwt of the block, the primary row k0 holds 0 */
+        L = (uint8_t*) safe_malloc(b);
+        isa = (int32_t*) safe_malloc(b*sizeof(int32_t));
+        k0 = 0;
+        for (i=0; i<b; i++) {
+            isa[sab[i]] = i;
+            if (sab[i] == 0) {
+                k0 = i;
+                L[i] = 0;
+            } else L[i] = t[s+sab[i]-1];
+        }
+        free(sab);
+
+        /* 2. gap array */
+        ngt = NULL;
+        if (s > 0) {
+            if ((f = tmpfile()) == NULL) fatal("tmpfile failed.");
+            ngt = gt_open(f);
+        }
+        G = gap_array(&e,s,b,L,k0,isa,ngt);
+
+        /* 3. merge */
+        nbwt = merge_bwt(&e,s,b,L,k0,isa,G,s > 0 ? NULL : out);
+        free(G);
+        free(L);
+
+        if (e.bwt) safe_fclose(e.bwt);
+        if (e.gt) gt_close(e.gt);
+        e.bwt = (s > 0) ? nbwt : NULL;
+        e.gt = ngt;
+        if (ngt) gt_flip(ngt);
+        e.rank = isa;
+        e.ts = s;
+    }
+
+    free(e.rank);
+}
@@ -0,0 +1,30 @@
+/*
+ * File:   libebwt.h
+ * Author: Matthias Petri
+ *
+ * external memory bwt
+ */
+
+#ifndef LIBEBWT_H
+#define	LIBEBWT_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* bytes of memory used per symbol of a block */
+#define EBWT_SPACE 26
+#define EBWT_MIN_BLOCK (64*1024)
+/* block suffixes are tagged with bit 30 while they are sorted */
+#define EBWT_MAX_BLOCK ((1 << 30) - 1)
+
+    void transform_bwt_external(const uint8_t* t,int64_t n,FILE* out,
+                                int64_t* idx,int32_t k,uint64_t mem);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBEBWT_H */
@@ -1,193 +1,318 @@
-/*
- * File:   libhuff.c
- * Author: Matthias Petri
- *
- * Canonical huffman encoding
- *
- */
-
-
-#include "libutil.h"
-#include "libhuff.h"
-#include "libpqueue.h"
-
-#define CHECK_BIT(var,pos) !!((var) & (1 << (pos)))
-
-void
-calc_code_len(hnode_t* n,uint32_t* clength,int32_t len)
-{
-    if (n != NULL) {
-        if (n->sym != -1) { /* leaf */
-            clength[n->sym] = len;
-        } else {
-            calc_code_len(n->left,clength,len+1);
-            calc_code_len(n->right,clength,len+1);
-        }
-    }
-}
-
-void
-calc_code_values(uint32_t* len,uint32_t* val)
-{
-    uint32_t min,max,l,i,j;
-    int32_t limit[ALPHABET_SIZE] = {0};
-    int32_t code_of_len[ALPHABET_SIZE] = {0};
-
-    /* compute min max and code_of_len */
-    min=255;
-    max=0;
-    for (i=0; i<ALPHABET_SIZE; i++) {
-        j=len[i];
-        if (j>0) {
-            code_of_len[j]++;
-            if (j>max) max = j;
-            if (j<min) min = j;
-        }
-    }
-
-
-    /* init limit: limit[i] is the largest code of a symbol of length i */
-    limit[min]=code_of_len[min]-1;
-    for (i=min+1; i<=max; i++) {
-        limit[i] = ((limit[i-1]+1)<<1)+code_of_len[i]-1;
-    }
-
-    /* compute codes */
-    for (i=0; i<ALPHABET_SIZE; i++) {
-        l=len[i];
-        val[i] = limit[l]-(--code_of_len[l]);
-    }
-}
-
-void
-encode_htree(uint32_t* clen,bit_file_t* of)
-{
-    uint32_t i,j;
-    int32_t code_of_len[ALPHABET_SIZE] = {0};
-    int32_t cstart[ALPHABET_SIZE] = {0};
-    uint8_t syms[ALPHABET_SIZE] = {0};
-    uint8_t n;
-
-
-    /* sort by code length */
-    n = 0;
-    for (i=0; i<ALPHABET_SIZE; i++) {
-        j=clen[i];
-        code_of_len[j]++;
-        if (j!=0) n++;
-    }
-    cstart[0] = 0;
-    code_of_len[0] = 0;
-    for (i=1; i<ALPHABET_SIZE; i++) {
-        cstart[i] = cstart[i-1] + code_of_len[i-1];
-    }
-
-    for (i=0; i<ALPHABET_SIZE; i++) {
-        if (clen[i]>0) {
-            syms[ cstart[clen[i]] ] = i;
-            cstart[clen[i]]++;
-        }
-    }
-
-    /* output */
-    BitFilePutChar(n-1,of); /* store n-1 */
-    for (i=0; i<n; i++) BitFilePutChar(syms[i],of); /* output sym */
-    for (i=0; i<n; i++) BitFilePutChar(clen[syms[i]],of); /* output len */
-
-}
-
-
-void
-write_symbol(uint8_t sym,uint32_t* code_table,uint32_t* code_len,bit_file_t* of)
-{
-    int32_t i,n;
-    uint32_t cw;
-
-    n = code_len[sym];
-    cw = code_table[sym];
-
-    for (i=0; i<n; i++) {
-        BitFilePutBit(CHECK_BIT(cw,n-i-1),of);
-    }
-}
-
-void
-encode_text(uint32_t* code_table,uint32_t* code_len,uint8_t* text,uint32_t n,bit_file_t* of)
-{
-    uint32_t i;
-
-    /* write number of symbols */
-    BitFilePutBitsInt(of,&n,32,sizeof(uint32_t));
-    fprintf(stderr,"n = %d\n",n);
-
-    /* encode the text */
-    for (i=0; i<n; i++) {
-        /* write symbol */
-        write_symbol(text[i],code_table,code_len,of);
-    }
-}
-
-/*
- * Main huffman encoding function. Use a heap based priority queue to create
- * the code words.
- */
-void
-encode_huffman(uint8_t* text,uint32_t n,bit_file_t* of)
-{
-    uint32_t i;
-    pqueue_t* pq;
-    hnode_t* left,*right,*new,*root;
-    uint32_t code_len[ALPHABET_SIZE] = {0};
-    uint32_t code_table[ALPHABET_SIZE] = {0};
-    uint32_t freqs[ALPHABET_SIZE] = {0};
-
-    /* count frequencies */
-    for (i=0; i<n; i++) freqs[text[i]]++;
-
-    /* create priority queue / heap */
-    pq = pqueue_create();
-
-    /* insert freqencies */
-    for (i=0; i<ALPHABET_SIZE; i++) {
-        if (freqs[i]>0) {
-            new = (hnode_t*) safe_malloc(sizeof(hnode_t));
-            new->sym = i;
-            new->freq = freqs[i];
-            new->left = NULL;
-            new->right = NULL;
-
-            pqueue_enqueue(pq,new,new->freq);
-        }
-    }
-
-    /* create tree */
-    root = NULL;
-    while (pqueue_isempty(pq)==0) {
-        left = pqueue_dequeue(pq);
-        right = pqueue_dequeue(pq);
-
-        if (left != NULL && right != NULL) {
-            new = (hnode_t*) safe_malloc(sizeof(hnode_t));
-            new->sym = -1;
-            new->freq = left->freq + right->freq;
-            new->left = (hnode_t*) left;
-            new->right = (hnode_t*) right;
-            pqueue_enqueue(pq,new,new->freq);
-        } else {
-            root = left;
-        }
-    }
-
-    /* calculate code lengths + values */
-    if (root) {
-        calc_code_len(root,code_len,0);
-
-        calc_code_values(code_len,code_table);
-    }
-
-    /* encode the tree info */
-    encode_htree(code_len,of);
-
-    /* encode the input */
-    encode_text(code_table,code_len,text,n,of);
-}
+/*
+ * File:   libhuff.c
+ * Author: Matthias Petri
+ *
+ * Canonical huffman encoding
+ *
+ * stream layout: number of code lengths - 1 (8 bits), the symbols
+ * ordered by code length, their code lengths (8 bits each), the number
+ * of coded symbols (64 bits, least significant byte first) and finally
+ * the codewords, msb first.
+ * codes of the same length are assigned in increasing symbol order.
+ *
+ */
+
+
+#include "libutil.h"
+#include "libhuff.h"
+#include "libpqueue.h"
+
+#define CHECK_BIT(var,pos) !!((var) & (1ULL << (pos)))
+
+void
+calc_code_len(hnode_t* n,uint32_t* clength,int32_t len)
+{
+    if (n != NULL) {
+        if (n->sym != -1) { /* leaf */
+            clength[n->sym] = len;
+        } else {
+            calc_code_len(n->left,clength,len+1);
+            calc_code_len(n->right,clength,len+1);
+        }
+    }
+}
+
+static void
+free_htree(hnode_t* n)
+{
+    if (n != NULL) {
+        free_htree(n->left);
+        free_htree(n->right);
+        free(n);
+    }
+}
+
+void
+calc_code_values(uint32_t* len,uint64_t* val)
+{
+    uint32_t min,max,l,i,j;
+    int64_t limit[ALPHABET_SIZE] = {0};
+    int32_t code_of_len[ALPHABET_SIZE] = {0};
+
+    /* compute min max and code_of_len */
+    min=255;
+    max=0;
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        j=len[i];
+        if (j>0) {
+            code_of_len[j]++;
+            if (j>max) max = j;
+            if (j<min) min = j;
+        }
+    }
+
+
+    /* init limit: limit[i] is the largest code of a symbol of length i */
+    limit[min]=code_of_len[min]-1;
+    for (i=min+1; i<=max; i++) {
+        limit[i] = ((limit[i-1]+1)<<1)+code_of_len[i]-1;
+    }
+
+    /* compute codes */
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        l=len[i];
+        val[i] = limit[l]-(--code_of_len[l]);
+    }
+}
+
+void
+encode_htree(uint32_t* clen,bit_file_t* of)
+{
+    uint32_t i,j;
+    int32_t code_of_len[ALPHABET_SIZE] = {0};
+    int32_t cstart[ALPHABET_SIZE] = {0};
+    uint8_t syms[ALPHABET_SIZE] = {0};
+    uint32_t n;
+
+
+    /* sort by code length */
+    n = 0;
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        j=clen[i];
+        code_of_len[j]++;
+        if (j!=0) n++;
+    }
+    cstart[0] = 0;
+    code_of_len[0] = 0;
+    for (i=1; i<ALPHABET_SIZE; i++) {
+        cstart[i] = cstart[i-1] + code_of_len[i-1];
+    }
+
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        if (clen[i]>0) {
+            syms[ cstart[clen[i]] ] = i;
+            cstart[clen[i]]++;
+        }
+    }
+
+    /* output */
+    BitFilePutChar(n-1,of); /* store n-1 */
+    for (i=0; i<n; i++) BitFilePutChar(syms[i],of); /* output sym */
+    for (i=0; i<n; i++) BitFilePutChar(clen[syms[i]],of); /* output len */
+
+}
+
+
+void
+write_symbol(uint8_t sym,uint64_t* code_table,uint32_t* code_len,bit_file_t* of)
+{
+    int32_t i,n;
+    uint64_t cw;
+
+    n = code_len[sym];
+    cw = code_table[sym];
+
+    for (i=0; i<n; i++) {
+        BitFilePutBit(CHECK_BIT(cw,n-i-1),of);
+    }
+}
+
+void
+encode_text(uint64_t* code_table,uint32_t* code_len,uint8_t* text,uint64_t n,bit_file_t* of)
+{
+    uint64_t i;
+
+    /* write number of symbols */
+    BitFilePutBitsInt(of,&n,64,sizeof(uint64_t));
+
+    /* encode the text */
+    for (i=0; i<n; i++) {
+        /* write symbol */
+        write_symbol(text[i],code_table,code_len,of);
+    }
+}
+
+/*
+ * Main huffman encoding function. Use a heap based priority queue to create
+ * the code words.
+ */
+void
+encode_huffman(uint8_t* text,uint64_t n,bit_file_t* of)
+{
+    uint64_t i;
+    pqueue_t* pq;
+    hnode_t* left,*right,*new,*root;
+    uint32_t code_len[ALPHABET_SIZE] = {0};
+    uint64_t code_table[ALPHABET_SIZE] = {0};
+    uint64_t freqs[ALPHABET_SIZE] = {0};
+
+    /* count frequencies */
+    for (i=0; i<n; i++) freqs[text[i]]++;
+
+    /* create priority queue / heap */
+    pq = pqueue_create();
+
+    /* insert freqencies */
+    for (i=0; i<ALPHABET_SIZE; i++) {
+        if (freqs[i]>0) {
+            new = (hnode_t*) safe_malloc(sizeof(hnode_t));
+            new->sym = i;
+            new->freq = freqs[i];
+            new->left = NULL;
+            new->right = NULL;
+
+            pqueue_enqueue(pq,new,new->freq);
+        }
+    }
+
+    /* create tree */
+    root = NULL;
+    while (pqueue_isempty(pq)==0) {
+        left = pqueue_dequeue(pq);
+        right = pqueue_dequeue(pq);
+
+        if (left != NULL && right != NULL) {
+            new = (hnode_t*) safe_malloc(sizeof(hnode_t));
+            new->sym = -1;
+            new->freq = left->freq + right->freq;
+            new->left = (hnode_t*) left;
+            new->right = (hnode_t*) right;
+            pqueue_enqueue(pq,new,new->freq);
+        } else {
+            root = left;
+        }
+    }
+
+    /* calculate code lengths + values. a single (or no) symbol still
+       gets a one bit code so the decoder always sees at least one */
+    if (root && root->sym == -1) {
+        calc_code_len(root,code_len,0);
+    } else {
+        code_len[root ? root->sym : 0] = 1;
+    }
+    free_htree(root);
+    pqueue_free(pq);
+    calc_code_values(code_len,code_table);
+
+    /* encode the tree info */
+    encode_htree(code_len,of);
+
+    /* encode the input */
+    encode_text(code_table,code_len,text,n,of);
+}
+
+/*
+ * canonical huffman decoding. codes of up to DECODE_BITS bits are
+ * resolved with a single table lookup, longer ones by walking the
+ * per length code limits.
+ */
+#define DECODE_BITS 11
+#define MAX_CODE_LEN 56
+
+typedef struct {
+    uint8_t* in;
+    uint8_t* end;
+    uint64_t buf;
+    int32_t bits;
+} bit_reader_t;
+
+static void
+br_refill(bit_reader_t* br)
+{
+    while (br->bits <= MAX_CODE_LEN) {
+        br->buf <<= 8;
+        if (br->in < br->end) br->buf |= *br->in++;
+        br->bits += 8;
+    }
+}
+
+#define br_peek(br,n) (((br)->buf >> ((br)->bits - (n))) & ((1ULL << (n)) - 1))
+
+uint8_t*
+decode_huffman(uint8_t* in,size_t len,uint64_t* size)
+{
+    uint64_t i,n;
+    uint32_t j,l,nsyms,max;
+    uint64_t code;
+    uint8_t syms[ALPHABET_SIZE];
+    uint8_t clen[ALPHABET_SIZE];
+    int64_t first[MAX_CODE_LEN+2],limit[MAX_CODE_LEN+2];
+    uint32_t offset[MAX_CODE_LEN+2],code_of_len[MAX_CODE_LEN+2];
+    uint16_t table[1<<DECODE_BITS];
+    uint8_t* out;
+    bit_reader_t br;
+
+    if (len < 1) fatal("huffman stream truncated.");
+    nsyms = in[0] + 1;
+    if (len < 1+2*nsyms+8) fatal("huffman stream truncated.");
+    memcpy(syms,in+1,nsyms);
+    memcpy(clen,in+1+nsyms,nsyms);
+    in += 1+2*nsyms;
+    n = 0;
+    for (i=0; i<8; i++) n |= (uint64_t)in[i] << (8*i);
+    in += 8;
+    len -= 1+2*nsyms+8;
+
+    /* rebuild the canonical code, see calc_code_values() */
+    memset(code_of_len,0,sizeof(code_of_len));
+    max = 0;
+    for (i=0; i<nsyms; i++) {
+        if (clen[i] < 1 || clen[i] > MAX_CODE_LEN) fatal("invalid huffman code length.");
+        code_of_len[clen[i]]++;
+        if (clen[i] > max) max = clen[i];
+    }
+    code = 0;
+    j = 0;
+    for (l=1; l<=max; l++) {
+        first[l] = code;
+        limit[l] = (int64_t) code + code_of_len[l] - 1;
+        offset[l] = j;
+        j += code_of_len[l];
+        code = (code + code_of_len[l]) << 1;
+    }
+
+    /* fill the lookup table: symbol in the low byte, length above */
+    memset(table,0,sizeof(table));
+    for (i=0; i<nsyms; i++) {
+        l = clen[i];
+        if (l > DECODE_BITS) continue;
+        code = first[l] + (i - offset[l]);
+        for (j = code << (DECODE_BITS-l); j < (code+1) << (DECODE_BITS-l); j++)
+            table[j] = (l << 8) | syms[i];
+    }
+
+    out = (uint8_t*) safe_malloc(MAX(n,1));
+    br.in = in;
+    br.end = in + len;
+    br.buf = 0;
+    br.bits = 0;
+    for (i=0; i<n; i++) {
+        br_refill(&br);
+        j = table[(uint32_t) br_peek(&br,DECODE_BITS)];
+        if (j) {
+            out[i] = j & 0xff;
+            br.bits -= j >> 8;
+            continue;
+        }
+        for (l=DECODE_BITS+1; l<=max; l++) {
+            code = br_peek(&br,l);
+            if ((int64_t) code <= limit[l]) break;
+        }
+        if (l > max) fatal("invalid huffman code.");
+        out[i] = syms[offset[l] + code - first[l]];
+        br.bits -= l;
+    }
+
+    *size = n;
+    return out;
+}
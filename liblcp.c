@@ -0,0 +1,81 @@
+/*
+ * File:   liblcp.c
+ * Author: Matthias Petri
+ *
+ * sse2 and avx2 versions of the unrolled suffix comparisons of the
+ * deep-shallow sorter. the bytes of two suffixes are compared a vector
+ * at a time, the first mismatch is found from the movemask of the
+ * byte compare. the instruction set is picked at run time by
+ * lcp_simd_level(), libbwt.c falls back to its scalar loops.
+ *
+ */
+
+#include "libutil.h"
+#include "liblcp.h"
+
+#ifdef LCP_HAVE_SIMD
+
+#include <immintrin.h>
+
+__attribute__((target("sse2"))) static int32_t
+mismatch_sse2(const uint8_t* b1,const uint8_t* b2)
+{
+    __m128i lo,hi;
+    uint32_t eq;
+
+    lo = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*) b1),
+                        _mm_loadu_si128((const __m128i*) b2));
+    hi = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(b1+16)),
+                        _mm_loadu_si128((const __m128i*)(b2+16)));
+    eq = (uint32_t) _mm_movemask_epi8(lo) | ((uint32_t) _mm_movemask_epi8(hi) << 16);
+    if (eq == 0xffffffff) return 32;
+    return __builtin_ctz(~eq);
+}
+
+__attribute__((target("avx2"))) static int32_t
+mismatch_avx2(const uint8_t* b1,const uint8_t* b2)
+{
+    __m256i x;
+    uint32_t eq;
+
+    x = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*) b1),
+                          _mm256_loadu_si256((const __m256i*) b2));
+    eq = (uint32_t) _mm256_movemask_epi8(x);
+    if (eq == 0xffffffff) return 32;
+    return __builtin_ctz(~eq);
+}
+
+#define LCP(f) f##_sse2
+#define LCP_TARGET __attribute__((target("sse2")))
+#define MISMATCH(b1,b2) mismatch_sse2(b1,b2)
+#include "liblcp_impl.h"
+#undef LCP
+#undef LCP_TARGET
+#undef MISMATCH
+
+#define LCP(f) f##_avx2
+#define LCP_TARGET __attribute__((target("avx2")))
+#define MISMATCH(b1,b2) mismatch_avx2(b1,b2)
+#include "liblcp_impl.h"
+#undef LCP
+#undef LCP_TARGET
+#undef MISMATCH
+
+lcp_simd_t
+lcp_simd_level(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return LCP_AVX2;
+    if (__builtin_cpu_supports("sse2")) return LCP_SSE2;
+    return LCP_SCALAR;
+}
+
+#else
+
+lcp_simd_t
+lcp_simd_level(void)
+{
+    return LCP_SCALAR;
+}
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * File:   liblcp.h
+ * Author: Matthias Petri
+ *
+ * vectorised suffix comparisons for the deep-shallow sorter
+ */
+
+#ifndef LIBLCP_H
+#define	LIBLCP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* x86 with a compiler that has target attributes and cpu detection */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LCP_HAVE_SIMD 1
+#endif
+
+/* the kernels read up to this many bytes past the start of the last
+   block they compare */
+#define LCP_OVERSHOOT 32
+
+    typedef enum {
+        LCP_SCALAR,
+        LCP_SSE2,
+        LCP_AVX2
+    } lcp_simd_t;
+
+    lcp_simd_t lcp_simd_level(void);
+
+#ifdef LCP_HAVE_SIMD
+    /*
+     * same results, Cmp_done/Cmp_left updates and loop limits as the
+     * 16 byte unrolled loops in libbwt.c, 32 bytes at a time.
+     */
+    int32_t get_lcp_sse2(const uint8_t* b1,const uint8_t* b2,int32_t cmp_limit);
+    int32_t cmp_lcp_sse2(const uint8_t* b1,const uint8_t* b2,const uint8_t* limit,
+                         int32_t* done);
+    int32_t cmp_shallow_lcp_sse2(const uint8_t* b1,const uint8_t* b2,int32_t* left);
+    int32_t get_lcp_avx2(const uint8_t* b1,const uint8_t* b2,int32_t cmp_limit);
+    int32_t cmp_lcp_avx2(const uint8_t* b1,const uint8_t* b2,const uint8_t* limit,
+                         int32_t* done);
+    int32_t cmp_shallow_lcp_avx2(const uint8_t* b1,const uint8_t* b2,int32_t* left);
+#endif
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBLCP_H */
@@ -0,0 +1,83 @@
+/*
+ * File:   liblcp_impl.h
+ * Author: Matthias Petri
+ *
+ * body of the vectorised suffix comparisons, see liblcp.c. it is
+ * included once per instruction set with LCP(f) naming the functions,
+ * LCP_TARGET their target attribute and MISMATCH(b1,b2) returning the
+ * position of the first difference in the next 32 bytes (32 if none).
+ *
+ * the scalar loops check their limit every 16 bytes, so does the
+ * second half of every 32 byte block here.
+ */
+
+LCP_TARGET int32_t
+LCP(get_lcp)(const uint8_t* b1,const uint8_t* b2,int32_t cmp_limit)
+{
+    int32_t cmp2do,p;
+
+    cmp2do = cmp_limit;
+    do {
+        p = MISMATCH(b1,b2);
+        if (p < 16) {
+            cmp2do -= p; break;
+        }
+        cmp2do -= 16;
+        if (cmp2do <= 0) break;
+        if (p < 32) {
+            cmp2do -= p - 16; break;
+        }
+        cmp2do -= 16;
+        b1 += 32; b2 += 32;
+    } while (cmp2do > 0);
+
+    if (cmp_limit - cmp2do < cmp_limit)
+        return cmp_limit - cmp2do;
+
+    return cmp_limit - 1;
+}
+
+LCP_TARGET int32_t
+LCP(cmp_lcp)(const uint8_t* b1,const uint8_t* b2,const uint8_t* limit,int32_t* done)
+{
+    int32_t p;
+
+    *done = 0;
+    do {
+        p = MISMATCH(b1,b2);
+        if (p < 16) {
+            *done += p; return (int32_t) b1[p] - (int32_t) b2[p];
+        }
+        *done += 16;
+        b1 += 16; b2 += 16;
+        if (b1 >= limit || b2 >= limit) break;
+        if (p < 32) {
+            *done += p - 16; return (int32_t) b1[p-16] - (int32_t) b2[p-16];
+        }
+        *done += 16;
+        b1 += 16; b2 += 16;
+    } while (b1 < limit && b2 < limit);
+
+    return b2 - b1;
+}
+
+LCP_TARGET int32_t
+LCP(cmp_shallow_lcp)(const uint8_t* b1,const uint8_t* b2,int32_t* left)
+{
+    int32_t p;
+
+    while (1) {
+        p = MISMATCH(b1,b2);
+        if (p < 16) {
+            *left -= p; return (int32_t) b1[p] - (int32_t) b2[p];
+        }
+        *left -= 16;
+        if (*left <= 0) return 0;
+        if (p < 32) {
+            *left -= p - 16; return (int32_t) b1[p] - (int32_t) b2[p];
+        }
+        *left -= 16;
+        if (*left <= 0) return 0;
+        b1 += 32; b2 += 32;
+    }
+}
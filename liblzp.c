@@ -0,0 +1,129 @@
+/*
+ * File:   liblzp.c
+ * Author: Matthias Petri
+ *
+ * lzp coding of long repeats. duplicated files or log sections make
+ * the suffixes of both copies agree for the whole length of the
+ * repeat, which the suffix sorter has to resolve. here every position
+ * predicts the last position that followed the same LZP_CTX bytes;
+ * if at least min_len bytes match the prediction they are replaced by
+ * the escape byte and the match length. the decoder keeps the same
+ * table over the text it has written, so no offsets are stored.
+ *
+ * tokens:  esc 0          a literal esc byte
+ *          esc l1 .. lk   a match of min_len-1+l1+..+lk bytes, with
+ *                         l1 > 0, l2..lk-1 == 255 and lk < 255
+ *          c              the literal c != esc
+ */
+
+#include "liblzp.h"
+
+static uint32_t
+lzp_hash(const uint8_t* t)
+{
+    uint64_t k = 0;
+    int32_t i;
+
+    /* byte by byte, so the hash does not depend on the host */
+    for (i=0; i<LZP_CTX; i++) k |= (uint64_t) t[i] << (8*i);
+    return (uint32_t)((k * 0x9E3779B97F4A7C15ULL) >> (64 - LZP_HASH_BITS));
+}
+
+/* the least frequent byte of in, it needs the fewest escapes */
+static uint8_t
+lzp_escape(const uint8_t* in,int64_t n)
+{
+    int64_t i,cnt[ALPHABET_SIZE];
+    int32_t c,best;
+
+    memset(cnt,0,sizeof(cnt));
+    for (i=0; i<n; i++) cnt[in[i]]++;
+    best = 0;
+    for (c=1; c<ALPHABET_SIZE; c++) if (cnt[c] < cnt[best]) best = c;
+    return (uint8_t) best;
+}
+
+/*
+ * code in[0..n-1] with matches of at least min_len bytes into out,
+ * which holds n bytes. returns the coded size, or -1 if that does not
+ * save 1/LZP_MIN_GAIN of n. the escape byte is returned in esc
+ */
+int64_t
+lzp_encode(const uint8_t* in,int64_t n,uint8_t* out,int32_t min_len,uint8_t* esc)
+{
+    int64_t* tab;
+    int64_t i,m,p,len,l,limit;
+    uint32_t h;
+    uint8_t e;
+
+    limit = n - n/LZP_MIN_GAIN;
+    if (n <= LZP_CTX || limit <= LZP_CTX) return -1;
+    e = *esc = lzp_escape(in,n);
+    tab = (int64_t*) safe_malloc(sizeof(int64_t) << LZP_HASH_BITS);
+
+    for (m=0; m<LZP_CTX; m++) out[m] = in[m];
+    for (i=LZP_CTX; i<n && m<limit;) {
+        h = lzp_hash(in+i-LZP_CTX);
+        p = tab[h];
+        tab[h] = i;
+        len = 0;
+        if (p > 0) while (i+len < n && in[p+len] == in[i+len]) len++;
+        if (len >= min_len) {
+            l = len-min_len+1;
+            if (m + 2 + l/255 > limit) break;
+            out[m++] = e;
+            for (; l >= 255; l -= 255) out[m++] = 255;
+            out[m++] = (uint8_t) l;
+            i += len;
+        } else if (in[i] == e) {
+            if (m + 2 > limit) break;
+            out[m++] = e;
+            out[m++] = 0;
+            i++;
+        } else out[m++] = in[i++];
+    }
+
+    free(tab);
+    return (i < n) ? -1 : m;
+}
+
+/* decode the m bytes of in into the n bytes of out */
+void
+lzp_decode(const uint8_t* in,int64_t m,uint8_t* out,int64_t n,int32_t min_len,uint8_t esc)
+{
+    int64_t* tab;
+    int64_t i,j,p,len;
+    uint32_t h;
+
+    if (m < MIN(n,LZP_CTX) || min_len < LZP_MIN_LEN)
+        fatal("block corrupt (lzp).");
+    tab = (int64_t*) safe_malloc(sizeof(int64_t) << LZP_HASH_BITS);
+
+    for (i=j=0; i<n && i<LZP_CTX; i++) out[i] = in[j++];
+    while (i < n) {
+        h = lzp_hash(out+i-LZP_CTX);
+        p = tab[h];
+        tab[h] = i;
+        if (j >= m) fatal("block corrupt (lzp).");
+        if (in[j] != esc) {
+            out[i++] = in[j++];
+            continue;
+        }
+        if (++j >= m) fatal("block corrupt (lzp).");
+        if (in[j] == 0) {
+            out[i++] = esc;
+            j++;
+            continue;
+        }
+        len = min_len-1;
+        while (j < m && in[j] == 255) len += in[j++];
+        if (j >= m) fatal("block corrupt (lzp).");
+        len += in[j++];
+        if (p == 0 || i+len > n) fatal("block corrupt (lzp).");
+        /* the match may overlap the bytes it writes */
+        for (; len > 0; len--) out[i++] = out[p++];
+    }
+    if (j != m) fatal("block corrupt (lzp).");
+
+    free(tab);
+}
@@ -0,0 +1,35 @@
+/*
+ * File:   liblzp.h
+ * Author: Matthias Petri
+ *
+ * lzp pre-pass replacing long repeats in front of the bwt
+ */
+
+#ifndef LIBLZP_H
+#define	LIBLZP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* a position is predicted by the hash of the LZP_CTX bytes before it */
+#define LZP_CTX 8
+#define LZP_HASH_BITS 18
+/* shortest match length that can be asked for */
+#define LZP_MIN_LEN 16
+/* blocks are only lzp coded if that saves at least 1/LZP_MIN_GAIN of
+   their size */
+#define LZP_MIN_GAIN 16
+
+    int64_t lzp_encode(const uint8_t* in,int64_t n,uint8_t* out,int32_t min_len,
+                       uint8_t* esc);
+    void lzp_decode(const uint8_t* in,int64_t m,uint8_t* out,int64_t n,
+                    int32_t min_len,uint8_t esc);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBLZP_H */
@@ -0,0 +1,136 @@
+/*
+ * File:   libpool.c
+ * Author: Matthias Petri
+ *
+ * fixed size pthread worker pool. tasks are run in submission order
+ * by the first idle worker. workers are numbered 0..nthreads-1 and the
+ * number is handed to the task so it can use per-worker state.
+ *
+ */
+
+#include "libutil.h"
+#include "libpool.h"
+
+typedef struct {
+    pool_t* pool;
+    int worker;
+} pool_worker_t;
+
+static void*
+pool_worker(void* arg)
+{
+    pool_worker_t* w = (pool_worker_t*) arg;
+    pool_t* pool = w->pool;
+    pool_task_t* task;
+
+    pthread_mutex_lock(&pool->lock);
+    while (1) {
+        while (pool->head == NULL && !pool->shutdown)
+            pthread_cond_wait(&pool->work,&pool->lock);
+        if (pool->head == NULL) break;
+
+        /* dequeue */
+        task = pool->head;
+        pool->head = task->next;
+        if (pool->head == NULL) pool->tail = NULL;
+        pthread_mutex_unlock(&pool->lock);
+
+        task->fn(task->arg,w->worker);
+
+        pthread_mutex_lock(&pool->lock);
+        task->done = 1;
+        pthread_cond_broadcast(&pool->finished);
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    free(w);
+    return NULL;
+}
+
+pool_t*
+pool_create(int32_t nthreads)
+{
+    int32_t i;
+    pool_t* pool;
+    pool_worker_t* w;
+
+    if (nthreads < 1) nthreads = 1;
+
+    pool = (pool_t*) safe_malloc(sizeof(pool_t));
+    pool->nthreads = nthreads;
+    pool->threads = (pthread_t*) safe_malloc(nthreads*sizeof(pthread_t));
+    pool->head = pool->tail = NULL;
+    pool->shutdown = 0;
+    pthread_mutex_init(&pool->lock,NULL);
+    pthread_cond_init(&pool->work,NULL);
+    pthread_cond_init(&pool->finished,NULL);
+
+    for (i=0; i<nthreads; i++) {
+        w = (pool_worker_t*) safe_malloc(sizeof(pool_worker_t));
+        w->pool = pool;
+        w->worker = i;
+        if (pthread_create(&pool->threads[i],NULL,pool_worker,w) != 0)
+            fatal("pool_create: cannot create thread %d",i);
+    }
+
+    return pool;
+}
+
+/*
+ * waits for all queued tasks to finish before stopping the workers
+ */
+void
+pool_free(pool_t* pool)
+{
+    int32_t i;
+
+    if (!pool) return;
+
+    pthread_mutex_lock(&pool->lock);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+
+    for (i=0; i<pool->nthreads; i++) pthread_join(pool->threads[i],NULL);
+
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work);
+    pthread_cond_destroy(&pool->finished);
+    free(pool->threads);
+    free(pool);
+}
+
+void
+pool_submit(pool_t* pool,pool_task_t* task,void (*fn)(void*,int),void* arg)
+{
+    task->fn = fn;
+    task->arg = arg;
+    task->done = 0;
+    task->next = NULL;
+
+    pthread_mutex_lock(&pool->lock);
+    if (pool->tail) pool->tail->next = task;
+    else pool->head = task;
+    pool->tail = task;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+void
+pool_task_wait(pool_t* pool,pool_task_t* task)
+{
+    pthread_mutex_lock(&pool->lock);
+    while (!task->done)
+        pthread_cond_wait(&pool->finished,&pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+int32_t
+pool_num_cpus()
+{
+    long n;
+
+    n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    return (int32_t) n;
+}
@@ -0,0 +1,48 @@
+/*
+ * File:   libpool.h
+ * Author: Matthias Petri
+ *
+ * fixed size pthread worker pool
+ */
+
+#ifndef LIBPOOL_H
+#define	LIBPOOL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <pthread.h>
+
+#include "libutil.h"
+
+    /* a task is owned by the caller and must stay alive until it is done */
+    typedef struct pool_task {
+        void (*fn)(void* arg,int worker);
+        void* arg;
+        int done;
+        struct pool_task* next;
+    } pool_task_t;
+
+    typedef struct {
+        int32_t nthreads;
+        pthread_t* threads;
+        pthread_mutex_t lock;
+        pthread_cond_t work;
+        pthread_cond_t finished;
+        pool_task_t* head;
+        pool_task_t* tail;
+        int shutdown;
+    } pool_t;
+
+    pool_t* pool_create(int32_t nthreads);
+    void pool_free(pool_t* pool);
+    void pool_submit(pool_t* pool,pool_task_t* task,void (*fn)(void*,int),void* arg);
+    void pool_task_wait(pool_t* pool,pool_task_t* task);
+    int32_t pool_num_cpus();
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBPOOL_H */
@@ -0,0 +1,95 @@
+/*
+ * File:   librank.c
+ * Author: Matthias Petri
+ *
+ * occurrences of a symbol in L[0..i) for the backward searches over a
+ * bwt. counts are sampled every 1 << log symbols, 2 bytes per symbol
+ * of the alphabet, and the rest is counted from the nearer sample 8
+ * symbols at a time: the bytes equal to c are found in a 64 bit word
+ * and added up with one multiplication.
+ */
+
+#include "librank.h"
+
+#define RANK_ONES 0x0101010101010101ULL
+#define RANK_LOW7 0x7f7f7f7f7f7f7f7fULL
+
+/* occurrences of c in p[0..len) */
+static int64_t
+count_symbol(const uint8_t* p,int64_t len,int c)
+{
+    uint64_t w,cc = RANK_ONES * (uint64_t) c;
+    int64_t i,cnt = 0;
+
+    for (i=0; i+8<=len; i+=8) {
+        memcpy(&w,p+i,8);
+        w ^= cc;
+        /* the top bit of every byte of w that is 0 */
+        w = ~(((w & RANK_LOW7) + RANK_LOW7) | w | RANK_LOW7);
+        cnt += (int64_t) (((w >> 7) * RANK_ONES) >> 56);
+    }
+    for (; i<len; i++) cnt += (p[i] == c);
+    return cnt;
+}
+
+/* bytes rank_init() allocates */
+uint64_t
+rank_space(int64_t n,int32_t log)
+{
+    return ((n >> log) + 1)*ALPHABET_SIZE*sizeof(uint16_t) +
+           (n/RANK_SUPER + 1)*ALPHABET_SIZE*sizeof(uint64_t);
+}
+
+void
+rank_init(rank_t* r,const uint8_t* L,int64_t n,int32_t log)
+{
+    uint64_t cnt[ALPHABET_SIZE];
+    uint64_t* base = NULL;
+    int64_t i,j,nb;
+    int32_t c;
+
+    if (log < 0 || log > RANK_MAX_LOG) fatal("invalid rank sampling %d.",log);
+    r->L = L;
+    r->n = n;
+    r->log = log;
+    nb = (n >> log) + 1;
+    r->blk = (uint16_t*) safe_malloc_large(nb*ALPHABET_SIZE*sizeof(uint16_t));
+    r->super = (uint64_t*) safe_malloc((n/RANK_SUPER + 1)*ALPHABET_SIZE*sizeof(uint64_t));
+
+    memset(cnt,0,sizeof(cnt));
+    for (j=0; j<nb; j++) {
+        i = j << log;
+        if (i % RANK_SUPER == 0) {
+            base = r->super + (i/RANK_SUPER)*ALPHABET_SIZE;
+            memcpy(base,cnt,sizeof(cnt));
+        }
+        for (c=0; c<ALPHABET_SIZE; c++)
+            r->blk[j*ALPHABET_SIZE+c] = (uint16_t) (cnt[c] - base[c]);
+        for (; i<MIN((j+1) << log,n); i++) cnt[L[i]]++;
+    }
+}
+
+void
+rank_free(rank_t* r)
+{
+    free_large(r->blk);
+    free(r->super);
+}
+
+/* occurrences of c before the j-th sample */
+#define RANK_SAMPLE(r,j,c) ((int64_t) (r)->super[(((j) << (r)->log)/RANK_SUPER)*ALPHABET_SIZE+(c)] + \
+                            (r)->blk[(j)*ALPHABET_SIZE+(c)])
+
+/* occurrences of c in L[0..i), 0 <= i <= n */
+int64_t
+rank_get(const rank_t* r,int c,int64_t i)
+{
+    int64_t j,lo,hi;
+
+    j = i >> r->log;
+    lo = j << r->log;
+    hi = lo + ((int64_t) 1 << r->log);
+    if (hi > r->n || i - lo <= hi - i)
+        return RANK_SAMPLE(r,j,c) + count_symbol(r->L+lo,i-lo,c);
+    return RANK_SAMPLE(r,j+1,c) - count_symbol(r->L+i,hi-i,c);
+}
@@ -0,0 +1,40 @@
+/*
+ * File:   librank.h
+ * Author: Matthias Petri
+ *
+ * occurrences of a symbol in a prefix of a bwt
+ */
+
+#ifndef LIBRANK_H
+#define	LIBRANK_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* absolute counts are kept every RANK_SUPER symbols, 16 bit ones
+   relative to them every 1 << log symbols, log at most RANK_MAX_LOG */
+#define RANK_SUPER 65536
+#define RANK_MAX_LOG 16
+
+    typedef struct {
+        const uint8_t* L;
+        int64_t n;
+        int32_t log;
+        uint64_t* super;    /* counts before every multiple of RANK_SUPER */
+        uint16_t* blk;      /* counts before every multiple of 1 << log,
+                               from the multiple of RANK_SUPER before it */
+    } rank_t;
+
+    uint64_t rank_space(int64_t n,int32_t log);
+    void rank_init(rank_t* r,const uint8_t* L,int64_t n,int32_t log);
+    void rank_free(rank_t* r);
+    int64_t rank_get(const rank_t* r,int c,int64_t i);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBRANK_H */
@@ -0,0 +1,83 @@
+/*
+ * File:   librle.c
+ * Author: Matthias Petri
+ *
+ * bzip2 style run length coding of long runs. coding runs of up to
+ * RLE1_RUN_MAX bytes in RLE1_RUN+1 bytes shrinks a block of zeros or a
+ * padded record file by up to 51 times, while text without long runs
+ * is hardly touched. it does not bound the lcps: a long run becomes
+ * a periodic string of codes, which is as deep for the deep-shallow
+ * sorter. such blocks go to sa-is, see bwt_fit_sorter().
+ */
+
+#include "librle.h"
+
+/* length of the run starting at in[i], at most RLE1_RUN_MAX */
+static uint64_t
+run_length(const uint8_t* in,uint64_t n,uint64_t i)
+{
+    uint64_t j = i+1;
+
+    while (j < n && j-i < RLE1_RUN_MAX && in[j] == in[i]) j++;
+    return j-i;
+}
+
+/* size of rle1_encode(in,n) */
+uint64_t
+rle1_size(const uint8_t* in,uint64_t n)
+{
+    uint64_t i,r,m = 0;
+
+    for (i=0; i<n; i+=r) {
+        r = run_length(in,n,i);
+        m += (r < RLE1_RUN) ? r : RLE1_RUN+1;
+    }
+    return m;
+}
+
+/*
+ * code in[0..n-1] into out, which holds rle1_size(in,n) bytes.
+ * returns the coded size
+ */
+uint64_t
+rle1_encode(const uint8_t* in,uint64_t n,uint8_t* out)
+{
+    uint64_t i,j,r,m = 0;
+
+    for (i=0; i<n; i+=r) {
+        r = run_length(in,n,i);
+        for (j=0; j<r && j<RLE1_RUN; j++) out[m++] = in[i];
+        if (r >= RLE1_RUN) out[m++] = (uint8_t)(r-RLE1_RUN);
+    }
+    return m;
+}
+
+/*
+ * decode the m bytes of in into the n bytes of out. a count after
+ * the RLE1_RUN-th equal byte starts a new run, so runs longer than
+ * RLE1_RUN_MAX are several codes in a row
+ */
+void
+rle1_decode(const uint8_t* in,uint64_t m,uint8_t* out,uint64_t n)
+{
+    uint64_t i,j = 0;
+    int32_t c,r,last = -1,run = 0;
+
+    for (i=0; i<m; i++) {
+        if (run == RLE1_RUN) {
+            r = in[i];
+            if (r > RLE1_RUN_MAX-RLE1_RUN || j+r > n) fatal("block corrupt (run length).");
+            memset(out+j,last,r);
+            j += r;
+            last = -1;
+            run = 0;
+            continue;
+        }
+        c = in[i];
+        if (j == n) fatal("block corrupt (run length).");
+        out[j++] = (uint8_t) c;
+        run = (c == last) ? run+1 : 1;
+        last = c;
+    }
+    if (j != n) fatal("block corrupt (run length).");
+}
@@ -0,0 +1,33 @@
+/*
+ * File:   librle.h
+ * Author: Matthias Petri
+ *
+ * run length pre-pass in front of the bwt
+ */
+
+#ifndef LIBRLE_H
+#define	LIBRLE_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* as in bzip2, RLE1_RUN equal bytes are followed by a count of
+   0..RLE1_RUN_MAX-RLE1_RUN further repeats */
+#define RLE1_RUN 4
+#define RLE1_RUN_MAX 255
+/* blocks are only run length coded if that saves at least
+   1/RLE1_MIN_GAIN of their size */
+#define RLE1_MIN_GAIN 8
+
+    uint64_t rle1_size(const uint8_t* in,uint64_t n);
+    uint64_t rle1_encode(const uint8_t* in,uint64_t n,uint8_t* out);
+    void rle1_decode(const uint8_t* in,uint64_t m,uint8_t* out,uint64_t n);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBRLE_H */
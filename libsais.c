@@ -0,0 +1,90 @@
+/*
+ * File:   libsais.c
+ * Author: Matthias Petri
+ *
+ * linear time suffix sorting by induced sorting (SA-IS) as described in
+ * Nong, Zhang and Chan, "Two Efficient Algorithms for Linear Time Suffix
+ * Array Construction". unlike deep-shallow sorting the running time does
+ * not depend on the lcp of the text, so it bounds the time spent on
+ * highly repetitive blocks.
+ *
+ * the text does not need a unique sentinel. position n is treated as an
+ * implicit sentinel smaller than every symbol, which gives the same
+ * order as ds_ssort (a suffix is smaller than all suffixes it prefixes).
+ *
+ * sais_bwt() computes the bwt directly: during the final induction every
+ * suffix is replaced by the character preceding it as soon as it has
+ * induced its predecessor (as in Mori's divbwt), so the bwt is read off
+ * the workspace sequentially instead of gathering t[sa[i]-1].
+ *
+ */
+
+#include "libutil.h"
+#include "libsais.h"
+
+/* 32 bit indices for blocks below 2 GiB */
+#define saidx_t int32_t
+#define SAIS(f) f##32
+#include "libsais_impl.h"
+#undef saidx_t
+#undef SAIS
+
+/* 64 bit indices for larger blocks */
+#define saidx_t int64_t
+#define SAIS(f) f##64
+#include "libsais_impl.h"
+#undef saidx_t
+#undef SAIS
+
+void sais_ssort(const uint8_t* t,int32_t* sa,int32_t n)
+{
+    if (n <= 0) return;
+    sais_main32(t,sa,0,n,ALPHABET_SIZE,sizeof(uint8_t),0,NULL,1);
+}
+
+/* suffix array of s[0..n-1] over the integer alphabet [0,k) */
+void sais_isort(const int32_t* s,int32_t* sa,int32_t n,int32_t k)
+{
+    if (n <= 0) return;
+    sais_main32(s,sa,0,n,k,sizeof(int32_t),0,NULL,1);
+}
+
+/*
+ * bwt of t[0..n-1] in the layout of transform_bwt(): t[n-1] followed by
+ * the last column with the row of suffix 0 removed. sa[0..n-1] is the
+ * workspace. out may be (uint8_t*) sa, byte i+1 of the output is only
+ * written after sa[i] has been read.
+ */
+void sais_bwt(const uint8_t* t,uint8_t* out,int32_t* sa,int32_t n,int32_t* idx,int32_t step)
+{
+    int32_t i,j,c,pidx;
+
+    if (n <= 0) return;
+    pidx = sais_main32(t,sa,0,n,ALPHABET_SIZE,sizeof(uint8_t),1,idx,step);
+
+    for (i=0,j=1; i<n; i++) {
+        c = sa[i];
+        if (i == 0) out[0] = t[n-1];
+        if (i != pidx) out[j++] = ~c;
+    }
+}
+
+void sais_ssort64(const uint8_t* t,int64_t* sa,int64_t n)
+{
+    if (n <= 0) return;
+    sais_main64(t,sa,0,n,ALPHABET_SIZE,sizeof(uint8_t),0,NULL,1);
+}
+
+void sais_bwt64(const uint8_t* t,uint8_t* out,int64_t* sa,int64_t n,int64_t* idx,int64_t step)
+{
+    int64_t i,j,c,pidx;
+
+    if (n <= 0) return;
+    pidx = sais_main64(t,sa,0,n,ALPHABET_SIZE,sizeof(uint8_t),1,idx,step);
+
+    for (i=0,j=1; i<n; i++) {
+        c = sa[i];
+        if (i == 0) out[0] = t[n-1];
+        if (i != pidx) out[j++] = ~c;
+    }
+}
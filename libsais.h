@@ -0,0 +1,28 @@
+/*
+ * File:   libsais.h
+ * Author: Matthias Petri
+ *
+ * linear time suffix sorting by induced sorting (SA-IS)
+ */
+
+#ifndef LIBSAIS_H
+#define	LIBSAIS_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+    void sais_ssort(const uint8_t* t,int32_t* sa,int32_t n);
+    void sais_isort(const int32_t* s,int32_t* sa,int32_t n,int32_t k);
+    void sais_bwt(const uint8_t* t,uint8_t* out,int32_t* sa,int32_t n,int32_t* idx,int32_t step);
+    void sais_ssort64(const uint8_t* t,int64_t* sa,int64_t n);
+    void sais_bwt64(const uint8_t* t,uint8_t* out,int64_t* sa,int64_t n,int64_t* idx,int64_t step);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBSAIS_H */
+
@@ -0,0 +1,221 @@
+/*
+ * File:   libsais_impl.h
+ * Author: Matthias Petri
+ *
+ * body of the SA-IS suffix sorter, see libsais.c. it is included once
+ * per index width with saidx_t set to the index type and SAIS(f)
+ * naming the functions of that width.
+ */
+
+/* one type bit per position: 1 = S-type, 0 = L-type */
+#define tget(i) ((t[(i) >> 3] >> ((i) & 7)) & 1)
+#define tset(i,b) { if (b) t[(i) >> 3] |= (1 << ((i) & 7)); \
+                    else t[(i) >> 3] &= ~(1 << ((i) & 7)); }
+#define chr(i) (cs == sizeof(uint8_t) ? ((const uint8_t*)s)[i] : ((const saidx_t*)s)[i])
+#define isLMS(i) ((i) > 0 && tget(i) && !tget((i)-1))
+
+/* start (end = 0) or end (end = 1) of every bucket */
+static void
+SAIS(get_buckets)(const void* s,saidx_t* bkt,saidx_t n,saidx_t K,int cs,int end)
+{
+    saidx_t i,sum;
+
+    memset(bkt,0,(size_t)K*sizeof(saidx_t));
+    for (i=0; i<n; i++) bkt[chr(i)]++;
+    sum = 0;
+    for (i=0; i<K; i++) {
+        sum += bkt[i];
+        bkt[i] = end ? sum : sum - bkt[i];
+    }
+}
+
+/* induce the L-type suffixes from the sorted LMS suffixes */
+static void
+SAIS(induce_l)(const uint8_t* t,saidx_t* SA,const void* s,saidx_t* bkt,saidx_t n,
+               saidx_t K,int cs)
+{
+    saidx_t i,j;
+
+    SAIS(get_buckets)(s,bkt,n,K,cs,0);
+    /* n-1 is induced by the implicit sentinel */
+    SA[bkt[chr(n-1)]++] = n-1;
+    for (i=0; i<n; i++) {
+        j = SA[i]-1;
+        if (SA[i] > 0 && !tget(j)) SA[bkt[chr(j)]++] = j;
+    }
+}
+
+/* induce the S-type suffixes from the sorted L-type suffixes */
+static void
+SAIS(induce_s)(const uint8_t* t,saidx_t* SA,const void* s,saidx_t* bkt,saidx_t n,
+               saidx_t K,int cs)
+{
+    saidx_t i,j;
+
+    SAIS(get_buckets)(s,bkt,n,K,cs,1);
+    for (i=n-1; i>=0; i--) {
+        j = SA[i]-1;
+        if (SA[i] > 0 && tget(j)) SA[--bkt[chr(j)]] = j;
+    }
+}
+
+/* record the row of sampled text positions */
+#define sample(j,row) { if (idx != NULL && (j) % step == 0) idx[(j) / step] = (row); }
+
+/*
+ * induce_l() for the final pass of sais_bwt(). an entry that has induced
+ * its predecessor is replaced by ~(preceding character). entries whose
+ * predecessor is S-type are left for induce_s_bwt().
+ */
+static void
+SAIS(induce_l_bwt)(const uint8_t* t,saidx_t* SA,const void* s,saidx_t* bkt,saidx_t n,
+                   saidx_t K,int cs,saidx_t* idx,saidx_t step)
+{
+    saidx_t i,j;
+
+    SAIS(get_buckets)(s,bkt,n,K,cs,0);
+    SA[bkt[chr(n-1)]++] = n-1;
+    for (i=0; i<n; i++) {
+        j = SA[i];
+        if (j < 0) continue;
+        /* rows of S-type suffixes are fixed up by induce_s_bwt */
+        sample(j,i);
+        if (j > 0 && !tget(j-1)) {
+            SA[bkt[chr(j-1)]++] = j-1;
+            SA[i] = ~chr(j-1);
+        }
+    }
+}
+
+/*
+ * induce_s() for the final pass of sais_bwt(). afterwards every entry
+ * holds ~(bwt character) except the row of suffix 0, which is returned.
+ */
+static saidx_t
+SAIS(induce_s_bwt)(const uint8_t* t,saidx_t* SA,const void* s,saidx_t* bkt,saidx_t n,
+                   saidx_t K,int cs,saidx_t* idx,saidx_t step)
+{
+    saidx_t i,j,pidx;
+
+    SAIS(get_buckets)(s,bkt,n,K,cs,1);
+    pidx = 0;
+    for (i=n-1; i>=0; i--) {
+        j = SA[i];
+        if (j < 0) continue;
+        sample(j,i);
+        if (j == 0) {
+            pidx = i;
+            continue;
+        }
+        if (tget(j-1)) SA[--bkt[chr(j-1)]] = j-1;
+        SA[i] = ~chr(j-1);
+    }
+    return pidx;
+}
+
+/*
+ * sort the suffixes of s[0..n-1] over the alphabet [0,K) into SA. cs is
+ * the size of one symbol. SA[n..n+fs-1] is unused scratch space which
+ * holds the bucket array when it is large enough.
+ * with bwt set the final pass leaves ~(bwt character) in SA instead
+ * of the suffixes, records the rows of the text positions that are
+ * multiples of step in idx (if not NULL) and returns the row of
+ * suffix 0. only used on the top level text.
+ */
+static saidx_t
+SAIS(sais_main)(const void* s,saidx_t* SA,saidx_t fs,saidx_t n,saidx_t K,int cs,
+                int bwt,saidx_t* idx,saidx_t step)
+{
+    uint8_t* t;
+    saidx_t* bkt,*s1,*SA1;
+    saidx_t i,j,n1,name,prev,pos,d,diff,pidx;
+
+    /* classify the suffixes, n-1 is L-type as it is larger than the sentinel */
+    t = (uint8_t*) safe_malloc((size_t)n/8+1);
+    tset(n-1,0);
+    for (i=n-2; i>=0; i--) {
+        tset(i,chr(i) < chr(i+1) || (chr(i) == chr(i+1) && tget(i+1)));
+    }
+
+    /* stage 1: sort the LMS substrings */
+    bkt = (K <= fs) ? SA + n : (saidx_t*) safe_malloc((size_t)K*sizeof(saidx_t));
+    SAIS(get_buckets)(s,bkt,n,K,cs,1);
+    for (i=0; i<n; i++) SA[i] = -1;
+    for (i=1; i<n; i++) {
+        if (isLMS(i)) SA[--bkt[chr(i)]] = i;
+    }
+    SAIS(induce_l)(t,SA,s,bkt,n,K,cs);
+    SAIS(induce_s)(t,SA,s,bkt,n,K,cs);
+    if (K > fs) free(bkt);
+
+    /* compact the sorted LMS substrings into SA[0..n1-1] */
+    n1 = 0;
+    for (i=0; i<n; i++) {
+        if (isLMS(SA[i])) SA[n1++] = SA[i];
+    }
+
+    /* name the LMS substrings. positions of LMS substrings are at
+       least two apart so SA[n1+pos/2] is unique for each of them.
+       the substring ending in the sentinel is unique. */
+    for (i=n1; i<n; i++) SA[i] = -1;
+    name = 0;
+    prev = -1;
+    for (i=0; i<n1; i++) {
+        pos = SA[i];
+        diff = 0;
+        for (d=0; d<n; d++) {
+            if (prev == -1 || pos+d == n || prev+d == n ||
+                    chr(pos+d) != chr(prev+d) || tget(pos+d) != tget(prev+d)) {
+                diff = 1;
+                break;
+            } else if (d > 0 && (isLMS(pos+d) || isLMS(prev+d))) break;
+        }
+        if (diff) {
+            name++;
+            prev = pos;
+        }
+        SA[n1+pos/2] = name-1;
+    }
+    for (i=n-1,j=n-1; i>=n1; i--) {
+        if (SA[i] >= 0) SA[j--] = SA[i];
+    }
+
+    /* stage 2: sort the reduced string, recursing if names repeat.
+       SA[n1..n-n1-1] is free while the reduced problem is solved. */
+    s1 = SA+n-n1;
+    SA1 = SA;
+    if (name < n1) SAIS(sais_main)(s1,SA1,n-2*n1,n1,name,sizeof(saidx_t),0,NULL,1);
+    else for (i=0; i<n1; i++) SA1[s1[i]] = i;
+
+    /* stage 3: induce the suffix array from the sorted LMS suffixes */
+    bkt = (K <= fs) ? SA + n : (saidx_t*) safe_malloc((size_t)K*sizeof(saidx_t));
+    SAIS(get_buckets)(s,bkt,n,K,cs,1);
+    for (i=1,j=0; i<n; i++) {
+        if (isLMS(i)) s1[j++] = i;
+    }
+    for (i=0; i<n1; i++) SA1[i] = s1[SA1[i]];
+    for (i=n1; i<n; i++) SA[i] = -1;
+    for (i=n1-1; i>=0; i--) {
+        j = SA[i];
+        SA[i] = -1;
+        SA[--bkt[chr(j)]] = j;
+    }
+    pidx = 0;
+    if (bwt) {
+        SAIS(induce_l_bwt)(t,SA,s,bkt,n,K,cs,idx,step);
+        pidx = SAIS(induce_s_bwt)(t,SA,s,bkt,n,K,cs,idx,step);
+    } else {
+        SAIS(induce_l)(t,SA,s,bkt,n,K,cs);
+        SAIS(induce_s)(t,SA,s,bkt,n,K,cs);
+    }
+    if (K > fs) free(bkt);
+
+    free(t);
+    return pidx;
+}
+
+#undef tget
+#undef tset
+#undef chr
+#undef isLMS
+#undef sample
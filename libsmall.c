@@ -0,0 +1,213 @@
+/*
+ * File:   libsmall.c
+ * Author: Matthias Petri
+ *
+ * bwt of blocks of up to SMALL_MAX_SIZE bytes. the suffix array and
+ * the ranks have 16 bit indices, half the cache footprint of int32_t
+ * ones, and stay in the caches together with the text. the suffixes
+ * are radix sorted on their first SMALL_DEPTH symbols, which leaves
+ * few of them unsorted on most blocks, and the rest is sorted by
+ * prefix doubling as in larsson and sadakane's qsufsort. there are no
+ * 65536 bigram buckets to clear as in ds_ssort() and no recursion as
+ * in sa-is, which are most of their time on a small block. a block of
+ * long repeats takes a doubling round per power of two of their
+ * length, so it is left to the other sorters after SMALL_WORK keys
+ * per suffix.
+ */
+
+#include "libsmall.h"
+
+/* a group a[0..m-1] of suffixes sharing their first h symbols */
+typedef struct {
+    int32_t i, m;
+} small_group_t;
+
+typedef struct {
+    small_group_t* g;
+    int32_t top, cap;
+} small_list_t;
+
+static void
+small_push(small_list_t* l,int32_t i,int32_t m)
+{
+    if (l->top == l->cap) {
+        l->cap = MAX(64,2*l->cap);
+        l->g = (small_group_t*) safe_realloc(l->g,l->cap*sizeof(small_group_t));
+    }
+    l->g[l->top].i = i;
+    l->g[l->top].m = m;
+    l->top++;
+}
+
+#define SMALL_SWAP(x,y) do { uint16_t _t = (x); (x) = (y); (y) = _t; } while (0)
+
+/* ternary quicksort of a[0..m-1] together with their keys k[0..m-1] */
+static void
+small_sort(uint16_t* a,uint16_t* k,int32_t m)
+{
+    uint16_t v, x, y;
+    int32_t lt, i, gt, j;
+
+    while (m > SMALL_INSSORT) {
+        x = k[0];
+        y = k[m-1];
+        v = k[m/2];
+        if ((x < v) == (v < y)) ;
+        else if ((v < x) == (x < y)) v = x;
+        else v = y;
+        lt = i = 0;
+        gt = m;
+        while (i < gt) {
+            if (k[i] < v) {
+                SMALL_SWAP(a[lt],a[i]);
+                SMALL_SWAP(k[lt],k[i]);
+                lt++;
+                i++;
+            } else if (k[i] > v) {
+                gt--;
+                SMALL_SWAP(a[i],a[gt]);
+                SMALL_SWAP(k[i],k[gt]);
+            } else i++;
+        }
+        if (lt < m - gt) {
+            small_sort(a,k,lt);
+            a += gt;
+            k += gt;
+            m -= gt;
+        } else {
+            small_sort(a+gt,k+gt,m-gt);
+            m = lt;
+        }
+    }
+    for (i = 1; i < m; i++) {
+        x = a[i];
+        y = k[i];
+        for (j = i; j > 0 && k[j-1] > y; j--) {
+            a[j] = a[j-1];
+            k[j] = k[j-1];
+        }
+        a[j] = x;
+        k[j] = y;
+    }
+}
+
+/* ****************************************************************
+   stable radix sort of all suffixes on their first SMALL_DEPTH
+   symbols, the last one first. the symbols past the end of the text
+   are 0, and the suffixes start in reverse so that of those which
+   the padding makes equal the shorter, smaller one comes first
+   **************************************************************** */
+static void
+small_radix(const uint8_t* t,uint16_t* sa,uint16_t* tmp,int32_t n)
+{
+    int32_t hist[256], cnt[256];
+    uint16_t *a = sa, *b = tmp, *p;
+    int32_t i, c, d, s, x;
+
+    for (i = 0; i < n; i++) sa[i] = (uint16_t) (n - 1 - i);
+    memset(hist,0,sizeof(hist));
+    for (i = 0; i < n; i++) hist[t[i]]++;
+    for (d = SMALL_DEPTH - 1; d >= 0; d--) {
+        /* the symbols at depth d are the text but its first d
+           symbols, and d times the padding */
+        memcpy(cnt,hist,sizeof(cnt));
+        for (i = 0; i < d && i < n; i++) cnt[t[i]]--;
+        cnt[0] += MIN(d,n);
+        for (c = 0; c < 256 && cnt[c] != n; c++) ;
+        if (c < 256) continue;
+        for (c = 0, s = 0; c < 256; c++) {
+            x = cnt[c];
+            cnt[c] = s;
+            s += x;
+        }
+        for (i = 0; i < n; i++) {
+            s = a[i] + d;
+            b[cnt[s < n ? t[s] : 0]++] = a[i];
+        }
+        p = a;
+        a = b;
+        b = p;
+    }
+    if (a != sa) memcpy(sa,a,n*sizeof(uint16_t));
+}
+
+/* do the suffixes at p and q agree on their first SMALL_DEPTH symbols
+   and go on past them. the one which ends there is the smaller one */
+static int
+small_same(const uint8_t* t,int32_t n,int32_t p,int32_t q)
+{
+    if (p + SMALL_DEPTH >= n || q + SMALL_DEPTH >= n) return 0;
+    return memcmp(t+p,t+q,SMALL_DEPTH) == 0;
+}
+
+/* ****************************************************************
+   bwt of t[0..n-1] in the layout of transform_bwt() into out, which
+   may be sa. idx[j] is the row of the suffix at j*step. returns 0
+   without touching out if the block has repeats too long for this
+   sort, see SMALL_WORK
+   **************************************************************** */
+int
+small_bwt(const uint8_t* t,uint8_t* out,uint16_t* sa,int32_t n,int32_t* idx,int32_t step)
+{
+    small_list_t cur, next, l;
+    uint16_t *isa, *key;
+    uint32_t* mark;
+    int32_t h, g, i, j, e, s, r, m;
+    int64_t work = (int64_t) n*SMALL_WORK;
+
+    if (n <= 0) return 1;
+    isa = (uint16_t*) safe_malloc(n*sizeof(uint16_t));
+    key = (uint16_t*) safe_malloc(n*sizeof(uint16_t));
+    small_radix(t,sa,key,n);
+
+    /* the rank of a suffix is the last row of its group */
+    cur.g = next.g = NULL;
+    cur.top = cur.cap = next.top = next.cap = 0;
+    for (i = 0; i < n; i = j) {
+        for (j = i + 1; j < n && small_same(t,n,sa[i],sa[j]); j++) ;
+        for (s = i; s < j; s++) isa[sa[s]] = (uint16_t) (j - 1);
+        if (j - i > 1) small_push(&cur,i,j-i);
+    }
+
+    /* the groups are sorted on the rank of the suffix h further on,
+       which sorts them on 2h symbols. a suffix in a group goes on past
+       h symbols, the shorter ones are told apart already */
+    for (h = SMALL_DEPTH; cur.top > 0; h *= 2) {
+        for (g = 0, m = 0; g < cur.top; g++) m += cur.g[g].m;
+        if ((work -= m) < 0) break;
+        for (g = 0; g < cur.top; g++) {
+            i = cur.g[g].i;
+            e = i + cur.g[g].m;
+            for (s = i; s < e; s++) key[s] = isa[sa[s]+h];
+            small_sort(sa+i,key+i,e-i);
+            for (s = i; s < e; s = j) {
+                for (j = s + 1; j < e && key[j] == key[s]; j++) ;
+                for (r = s; r < j; r++) isa[sa[r]] = (uint16_t) (j - 1);
+                if (j - s > 1) small_push(&next,s,j-s);
+            }
+        }
+        l = cur;
+        cur = next;
+        next = l;
+        next.top = 0;
+    }
+    free(cur.g);
+    free(next.g);
+    free(key);
+    free(isa);
+    if (work < 0) return 0;
+
+    /* the sampled positions are marked, so there is no division per row */
+    mark = (uint32_t*) safe_malloc(((n >> 5) + 1)*sizeof(uint32_t));
+    for (s = 0; s < n; s += step) mark[s >> 5] |= (uint32_t) 1 << (s & 31);
+    /* out[j] is written after sa[i] with i >= j-1 is read, which
+       leaves the rest of sa alone if out is sa */
+    for (i = 0, j = 1; i < n; i++) {
+        s = sa[i];
+        if (i == 0) out[0] = t[n-1];
+        if ((mark[s >> 5] >> (s & 31)) & 1) idx[s / step] = i;
+        if (s != 0) out[j++] = t[s-1];
+    }
+    free(mark);
+    return 1;
+}
@@ -0,0 +1,32 @@
+/*
+ * File:   libsmall.h
+ * Author: Matthias Petri
+ *
+ * bwt of small blocks with 16 bit suffix indices
+ */
+
+#ifndef LIBSMALL_H
+#define	LIBSMALL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* largest block, the suffixes 0..65535 fit an uint16_t */
+#define SMALL_MAX_SIZE 65536
+/* the suffixes are radix sorted on this many symbols first */
+#define SMALL_DEPTH 8
+/* groups of at most this many suffixes are insertion sorted */
+#define SMALL_INSSORT 16
+/* the doubling gives up after this many keys per suffix */
+#define SMALL_WORK 2
+
+    int small_bwt(const uint8_t* t,uint8_t* out,uint16_t* sa,int32_t n,int32_t* idx,int32_t step);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBSMALL_H */
@@ -0,0 +1,149 @@
+/*
+ * File:   libst.c
+ * Author: Matthias Petri
+ *
+ * st-k (schindler) transform. the rotations of the text are sorted by
+ * their first k characters only, rotations with the same context stay
+ * in text order. the last column is output as for the bwt. sorting
+ * takes ceil(k/2) stable radix passes over 16 bit digits, the same
+ * bigram buckets ds_ssort starts with, so the time does not depend
+ * on the text. the compression is a little below that of the bwt.
+ */
+
+#include "libst.h"
+
+#define ST_BUCKETS 65536
+
+/* ***************************************************************
+   st-k of input[0..n-1] into out[0..n-1], *I is the row of the
+   rotation starting at text position 0. if out is NULL the output is
+   written over a scratch array which is then shrunk to n bytes and
+   returned (free_large() it).
+   the rotations are sorted lsd first: the pass over the characters
+   at offsets o and o+1 is stable, so after the pass over offsets 0,1
+   (or only 0 for odd k) they are in context order and within a
+   context in text order.
+   *************************************************************** */
+uint8_t* transform_st(uint8_t* input,int64_t n,uint8_t* out,int64_t* I,int32_t k)
+{
+    int32_t* cnt,*sa,*tmp,*swap;
+    uint8_t* x;
+    int32_t i,o,s,sum,c;
+
+    if (k < ST_MIN_ORDER || k > ST_MAX_ORDER) fatal("invalid st order %d.",k);
+    if (n > ST_MAX_SIZE) fatal("st block too large (%ld bytes).",(long)n);
+    *I = 0;
+    if (n == 0) return out ? out : (uint8_t*) safe_malloc_large(1);
+
+    /* the text followed by its first k characters, so contexts wrap */
+    x = (uint8_t*) safe_malloc_large(n+k);
+    for (i=0; i<n+k; i++) x[i] = input[i % n];
+
+    cnt = (int32_t*) safe_malloc(ST_BUCKETS*sizeof(int32_t));
+    sa = (int32_t*) safe_malloc_large(n*sizeof(int32_t));
+    tmp = (int32_t*) safe_malloc_large(n*sizeof(int32_t));
+    for (i=0; i<n; i++) sa[i] = i;
+
+    for (o = k-2; o > -2; o -= 2) {
+        memset(cnt,0,ST_BUCKETS*sizeof(int32_t));
+        if (o < 0) {
+            /* odd k, the last pass is over one character */
+            for (i=0; i<n; i++) cnt[x[i]]++;
+        } else {
+            for (i=0; i<n; i++) cnt[(x[i+o] << 8) | x[i+o+1]]++;
+        }
+        for (sum=0,c=0; c<ST_BUCKETS; c++) {
+            s = cnt[c];
+            cnt[c] = sum;
+            sum += s;
+        }
+        if (o < 0) {
+            for (i=0; i<n; i++) tmp[cnt[x[sa[i]]]++] = sa[i];
+        } else {
+            for (i=0; i<n; i++) {
+                s = sa[i];
+                tmp[cnt[(x[s+o] << 8) | x[s+o+1]]++] = s;
+            }
+        }
+        swap = sa; sa = tmp; tmp = swap;
+    }
+    free(cnt);
+
+    if (out == NULL) out = (uint8_t*) tmp;
+    for (i=0; i<n; i++) {
+        s = sa[i];
+        if (s == 0) *I = i;
+        out[i] = x[s == 0 ? n-1 : s-1];
+    }
+
+    free_large(sa);
+    free_large(x);
+    if (out == (uint8_t*) tmp) out = (uint8_t*) safe_shrink_large(tmp,n);
+    else free_large(tmp);
+
+    return out;
+}
+
+/* ***************************************************************
+   inverse of transform_st(). the lf mapping of the bwt sends a row
+   with context X and last character c into the group of rows with
+   context cX[0..k-2], but not to the right row within it. the groups
+   are found with k lf passes, each extending the contexts by one
+   character: grp[r] is the first row of the group of row r.
+   the text is then decoded back to front. the rows of a group are in
+   text order, so the rows of each group are used from the last to
+   the first.
+   *************************************************************** */
+uint8_t* reverse_st(uint8_t* in,int64_t n,int64_t I,int32_t k,uint8_t* out)
+{
+    int64_t C[ALPHABET_SIZE],sum,tmp;
+    int32_t last[ALPHABET_SIZE],start[ALPHABET_SIZE];
+    int32_t* lf,*grp,*next,*swap;
+    int32_t i,j,r,c;
+
+    if (n <= 0) return out;
+    if (k < ST_MIN_ORDER || k > ST_MAX_ORDER) fatal("invalid st order %d.",k);
+    if (n > ST_MAX_SIZE || I < 0 || I >= n) fatal("invalid primary index %ld.",(long)I);
+
+    memset(C,0,sizeof(C));
+    for (i=0; i<n; i++) C[in[i]]++;
+    for (sum=0,c=0; c<ALPHABET_SIZE; c++) {
+        tmp = C[c];
+        C[c] = sum;
+        sum += tmp;
+    }
+    lf = (int32_t*) safe_malloc_large(n*sizeof(int32_t));
+    for (i=0; i<n; i++) lf[i] = C[in[i]]++;
+
+    /* all rows share the empty context */
+    grp = (int32_t*) safe_malloc_large(n*sizeof(int32_t));
+    next = (int32_t*) safe_malloc_large(n*sizeof(int32_t));
+    for (j=0; j<k; j++) {
+        for (c=0; c<ALPHABET_SIZE; c++) last[c] = -1;
+        for (r=0; r<n; r++) {
+            c = in[r];
+            if (grp[r] != last[c]) {
+                last[c] = grp[r];
+                start[c] = lf[r];
+            }
+            next[lf[r]] = start[c];
+        }
+        swap = grp; grp = next; next = swap;
+    }
+
+    /* next[g] is the last unused row of the group starting at row g */
+    for (r=n-1; r>=0; r--) if (r == n-1 || grp[r+1] != grp[r]) next[grp[r]] = r;
+
+    r = I;
+    for (i=n-1; i>0; i--) {
+        out[i] = in[r];
+        r = next[grp[lf[r]]]--;
+    }
+    out[0] = in[r];
+
+    free_large(next);
+    free_large(grp);
+    free_large(lf);
+
+    return out;
+}
@@ -0,0 +1,30 @@
+/*
+ * File:   libst.h
+ * Author: Matthias Petri
+ *
+ * schindler transform, the bwt with contexts sorted to a fixed depth
+ */
+
+#ifndef LIBST_H
+#define	LIBST_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* context lengths that can be asked for */
+#define ST_MIN_ORDER 2
+#define ST_MAX_ORDER 8
+/* rows are 32 bit */
+#define ST_MAX_SIZE INT32_MAX
+
+    uint8_t* transform_st(uint8_t* input,int64_t n,uint8_t* out,int64_t* I,int32_t k);
+    uint8_t* reverse_st(uint8_t* in,int64_t n,int64_t I,int32_t k,uint8_t* out);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBST_H */
@@ -1,149 +1,475 @@
-/*
- * File:   libutil.c
- * Author: Matthias Petri
- *
- * misc support functions
- *
- */
-
-#include "libutil.h"
-
-
-/*  safe_malloc ()
- *
- *  Call calloc () and abort if the specified amount of
- *  memory cannot be allocated.
- */
-
-void*
-safe_malloc(size_t size)
-{
-    void* mem_block = NULL;
-
-    if ((mem_block = calloc(1, size)) == NULL) {
-        fprintf(stderr, "ERROR: safe_malloc(%zu) cannot allocate memory.", size);
-        exit(EXIT_FAILURE);
-    }
-    return (mem_block);
-}
-
-/*  safe_realloc ()
- *
- *  Call realloc () and abort if the specified amount of
- *  memory cannot be allocated.
- */
-
-void*
-safe_realloc(void* old_mem, size_t new_size)
-{
-    if ((old_mem = realloc(old_mem, new_size)) == NULL) {
-        fprintf(stderr, "ERROR: safe_realloc() cannot allocate"
-                "%zu blocks of memory.\n", new_size);
-        exit(EXIT_FAILURE);
-    }
-    return (old_mem);
-}
-
-/*
- * safe_strdup ()
- *
- * Safe version of strdup avoid buffer overflow, etc.
- *
- */
-
-char*
-safe_strdup(const char* str)
-{
-    char* copy = NULL;
-
-    if (str == NULL) {
-        fprintf(stderr, "ERROR safe_strdup(): str == NULL");
-        exit(EXIT_FAILURE);
-    }
-
-    copy = safe_malloc((strlen(str) + 1) * sizeof(char));
-
-    (void) strcpy(copy, str);
-
-    return (copy);
-}
-
-char*
-safe_strcat(char* str1, const char* str2)
-{
-    char* rv = NULL;
-    size_t len = 0;
-
-    if (str1 == NULL || str2 == NULL) {
-        fprintf(stderr, "ERROR safe_strcat_new(): str == NULL");
-        exit(EXIT_FAILURE);
-    }
-    len = strlen(str1) + strlen(str2) + 1;
-    rv = safe_malloc(len * sizeof(char));
-    (void) strcpy(rv, str1);
-    rv = strcat(rv, str2);
-    return (rv);
-}
-
-
-FILE*
-safe_fopen(const char* filename,const char* mode)
-{
-    FILE* f;
-    f = fopen(filename,mode);
-    if (f == NULL) {
-        fprintf(stderr, "ERROR: safe_fopen(%s,%s)\n", filename,mode);
-        exit(EXIT_FAILURE);
-    }
-    return (f);
-}
-
-void
-safe_fclose(FILE* f)
-{
-    if (fclose(f) != 0) {
-        perror("Error: file close():");
-        exit(EXIT_FAILURE);
-    }
-}
-
-int
-safe_filesize(FILE* f)
-{
-    int size;
-    int cur = ftell(f);
-    if (cur == -1) {
-        perror("Error: file ftell():");
-        exit(EXIT_FAILURE);
-    } else {
-        fseek(f,0,SEEK_END);
-        size = ftell(f);
-        if (size == -1) {
-            perror("Error: file ftell():");
-            exit(EXIT_FAILURE);
-        }
-        fseek(f,cur,SEEK_SET);
-    }
-    return size;
-}
-
-void
-fatal(const char* format, ...)
-{
-    va_list vargs;
-
-    va_start(vargs, format);
-    vfprintf(stderr, format, vargs);
-    fprintf(stderr, "\n");
-    exit(EXIT_FAILURE);
-}
-
-uint64_t
-gettime()
-{
-    struct timeval tp;
-
-    gettimeofday(&tp,NULL);
-
-    return (tp.tv_sec*1000000) + tp.tv_usec;
-}
+/*
+ * File:   libutil.c
+ * Author: Matthias Petri
+ *
+ * misc support functions
+ *
+ */
+
+/* MAP_ANONYMOUS, madvise() flags and syscall() */
+#define _DEFAULT_SOURCE
+
+#include "libutil.h"
+
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+
+/*  safe_malloc ()
+ *
+ *  Call calloc () and abort if the specified amount of
+ *  memory cannot be allocated.
+ */
+
+void*
+safe_malloc(size_t size)
+{
+    void* mem_block = NULL;
+
+    if ((mem_block = calloc(1, size)) == NULL) {
+        fprintf(stderr, "ERROR: safe_malloc(%zu) cannot allocate memory.", size);
+        exit(EXIT_FAILURE);
+    }
+    return (mem_block);
+}
+
+/*  safe_realloc ()
+ *
+ *  Call realloc () and abort if the specified amount of
+ *  memory cannot be allocated.
+ */
+
+void*
+safe_realloc(void* old_mem, size_t new_size)
+{
+    if ((old_mem = realloc(old_mem, new_size)) == NULL) {
+        fprintf(stderr, "ERROR: safe_realloc() cannot allocate"
+                "%zu blocks of memory.\n", new_size);
+        exit(EXIT_FAILURE);
+    }
+    return (old_mem);
+}
+
+/*
+ * safe_strdup ()
+ *
+ * Safe version of strdup avoid buffer overflow, etc.
+ *
+ */
+
+char*
+safe_strdup(const char* str)
+{
+    char* copy = NULL;
+
+    if (str == NULL) {
+        fprintf(stderr, "ERROR safe_strdup(): str == NULL");
+        exit(EXIT_FAILURE);
+    }
+
+    copy = safe_malloc((strlen(str) + 1) * sizeof(char));
+
+    (void) strcpy(copy, str);
+
+    return (copy);
+}
+
+char*
+safe_strcat(char* str1, const char* str2)
+{
+    char* rv = NULL;
+    size_t len = 0;
+
+    if (str1 == NULL || str2 == NULL) {
+        fprintf(stderr, "ERROR safe_strcat_new(): str == NULL");
+        exit(EXIT_FAILURE);
+    }
+    len = strlen(str1) + strlen(str2) + 1;
+    rv = safe_malloc(len * sizeof(char));
+    (void) strcpy(rv, str1);
+    rv = strcat(rv, str2);
+    return (rv);
+}
+
+
+FILE*
+safe_fopen(const char* filename,const char* mode)
+{
+    FILE* f;
+    f = fopen(filename,mode);
+    if (f == NULL) {
+        fprintf(stderr, "ERROR: safe_fopen(%s,%s)\n", filename,mode);
+        exit(EXIT_FAILURE);
+    }
+    return (f);
+}
+
+void
+safe_fclose(FILE* f)
+{
+    if (fclose(f) != 0) {
+        perror("Error: file close():");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * 32 and 64 bit integers in container headers are stored most
+ * significant byte first.
+ */
+void
+write_uint32(FILE* f,uint32_t v)
+{
+    uint8_t buf[4];
+
+    buf[0] = (v >> 24) & 0xff;
+    buf[1] = (v >> 16) & 0xff;
+    buf[2] = (v >> 8) & 0xff;
+    buf[3] = v & 0xff;
+    if (fwrite(buf,1,4,f) != 4) {
+        perror("Error: file fwrite():");
+        exit(EXIT_FAILURE);
+    }
+}
+
+uint32_t
+read_uint32(FILE* f)
+{
+    uint8_t buf[4];
+
+    if (fread(buf,1,4,f) != 4) fatal("ERROR: unexpected end of file.");
+
+    return ((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) |
+           ((uint32_t)buf[2] << 8) | (uint32_t)buf[3];
+}
+
+void
+write_uint64(FILE* f,uint64_t v)
+{
+    write_uint32(f,(uint32_t)(v >> 32));
+    write_uint32(f,(uint32_t) v);
+}
+
+uint64_t
+read_uint64(FILE* f)
+{
+    uint64_t v;
+
+    v = (uint64_t) read_uint32(f) << 32;
+    return v | read_uint32(f);
+}
+
+/* uses fseeko/ftello so files over 2 GiB work with 32 bit long */
+int64_t
+safe_filesize(FILE* f)
+{
+    off_t size;
+    off_t cur = ftello(f);
+    if (cur == -1) {
+        perror("Error: file ftell():");
+        exit(EXIT_FAILURE);
+    } else {
+        fseeko(f,0,SEEK_END);
+        size = ftello(f);
+        if (size == -1) {
+            perror("Error: file ftell():");
+            exit(EXIT_FAILURE);
+        }
+        fseeko(f,cur,SEEK_SET);
+    }
+    return size;
+}
+
+/*
+ * map the first len bytes of f. a writable mapping is shared with the
+ * file, which is first extended to len bytes. this lets block sized
+ * buffers of the external mode live in the page cache instead of
+ * anonymous memory.
+ */
+uint8_t*
+safe_mmap(FILE* f,size_t len,int writable)
+{
+    void* p;
+
+    fflush(f);
+    if (writable && ftruncate(fileno(f),len) != 0) {
+        perror("Error: file ftruncate():");
+        exit(EXIT_FAILURE);
+    }
+    p = mmap(NULL,len,writable ? PROT_READ|PROT_WRITE : PROT_READ,
+             MAP_SHARED,fileno(f),0);
+    if (p == MAP_FAILED) {
+        perror("Error: file mmap():");
+        exit(EXIT_FAILURE);
+    }
+    return (uint8_t*) p;
+}
+
+void
+safe_munmap(uint8_t* p,size_t len)
+{
+    if (munmap(p,len) != 0) {
+        perror("Error: file munmap():");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/*
+ * large buffers. the suffix arrays and the text of a block are read
+ * in random order, so with 4 kB pages almost every access is a tlb
+ * miss. buffers of LARGE_ALLOC_MIN bytes or more are mapped on their
+ * own, from the reserved 2 MiB pages if there are any and otherwise
+ * 2 MiB aligned and advised for transparent huge pages. the mapping
+ * prefers the numa node of the thread that allocates it, which is the
+ * worker sorting the block. smaller buffers come from calloc. a
+ * header before the buffer says which it is.
+ */
+#define LARGE_HDR 64
+#define HUGE_PAGE (2*1024*1024)
+/* of mbind(), <numaif.h> comes with libnuma which is not linked */
+#define LARGE_MPOL_PREFERRED 1
+
+typedef struct {
+    uint8_t* map;       /* NULL for calloc */
+    size_t len;         /* of the mapping */
+    size_t size;
+    int32_t hugetlb;
+    int32_t counted;
+} large_hdr_t;
+
+static pthread_mutex_t large_lock = PTHREAD_MUTEX_INITIALIZER;
+static large_stats_t large_total;
+static int large_track = 0;
+
+/* numa node of the calling thread, -1 if unknown */
+static int32_t
+current_node(void)
+{
+#ifdef SYS_getcpu
+    unsigned cpu,node;
+
+    if (syscall(SYS_getcpu,&cpu,&node,NULL) == 0) return (int32_t) node;
+#endif
+    return -1;
+}
+
+/* let the pages of map come from the node of the calling thread while
+   it has free memory. returns the node, -1 if it could not be bound */
+static int32_t
+large_bind(uint8_t* map,size_t len)
+{
+#ifdef SYS_mbind
+    unsigned long mask;
+    int32_t node = current_node();
+
+    if (node < 0 || node >= (int32_t) (8*sizeof(mask))) return -1;
+    mask = 1UL << node;
+    if (syscall(SYS_mbind,map,len,LARGE_MPOL_PREFERRED,&mask,
+                (unsigned long) (8*sizeof(mask)),0) == 0)
+        return node;
+#else
+    (void) map;
+    (void) len;
+#endif
+    return -1;
+}
+
+/* nodes holding the pages of map, from the first 4 kB page of every
+   2 MiB with a single move_pages(). pages never touched are left out */
+static uint64_t
+large_nodes(uint8_t* map,size_t len)
+{
+    uint64_t nodes = 0;
+#ifdef SYS_move_pages
+    void** pages;
+    int* status;
+    size_t i, count = (len + HUGE_PAGE - 1) / HUGE_PAGE;
+
+    pages = (void**) safe_malloc(count*sizeof(void*));
+    status = (int*) safe_malloc(count*sizeof(int));
+    for (i = 0; i < count; i++) pages[i] = map + i*HUGE_PAGE;
+    if (syscall(SYS_move_pages,0,count,pages,NULL,status,0) == 0) {
+        for (i = 0; i < count; i++)
+            if (status[i] >= 0 && status[i] < 64) nodes |= (uint64_t) 1 << status[i];
+    }
+    free(status);
+    free(pages);
+#else
+    (void) map;
+    (void) len;
+#endif
+    return nodes;
+}
+
+/*
+ * bytes of the mapping at map backed by transparent huge pages, from
+ * the AnonHugePages of its vma in /proc/self/smaps. adjacent mappings
+ * may share a vma, so this is capped at len.
+ */
+static uint64_t
+thp_bytes(const uint8_t* map,size_t len)
+{
+    FILE* f;
+    char line[256];
+    unsigned long lo,hi,kb;
+    int found = 0;
+    uint64_t bytes = 0;
+
+    if ((f = fopen("/proc/self/smaps","r")) == NULL) return 0;
+    while (fgets(line,sizeof(line),f) != NULL) {
+        if (sscanf(line,"%lx-%lx ",&lo,&hi) == 2) {
+            found = (unsigned long) map >= lo && (unsigned long) map < hi;
+        } else if (found && sscanf(line,"AnonHugePages: %lu kB",&kb) == 1) {
+            bytes = MIN((uint64_t) kb*1024,len);
+            break;
+        }
+    }
+    fclose(f);
+    return bytes;
+}
+
+/* add where the pages of a filled buffer are to the statistics, once.
+   only with large_track_pages(), it reads /proc/self/smaps */
+static void
+large_count(large_hdr_t* h)
+{
+    uint64_t huge,nodes;
+
+    if (!large_track || h->counted || h->map == NULL) return;
+    h->counted = 1;
+    huge = h->hugetlb ? h->len : thp_bytes(h->map,h->len);
+    nodes = large_nodes(h->map,h->len);
+    pthread_mutex_lock(&large_lock);
+    large_total.huge_bytes += huge;
+    large_total.nodes |= nodes;
+    pthread_mutex_unlock(&large_lock);
+}
+
+void*
+safe_malloc_large(size_t size)
+{
+    large_hdr_t* h;
+    uint8_t* p = MAP_FAILED;
+    size_t len,skip;
+    int32_t node;
+
+    if (size < LARGE_ALLOC_MIN) {
+        h = (large_hdr_t*) safe_malloc(size + LARGE_HDR);
+        return (uint8_t*) h + LARGE_HDR;
+    }
+
+    len = (size + LARGE_HDR + HUGE_PAGE - 1) & ~((size_t) HUGE_PAGE - 1);
+#ifdef MAP_HUGETLB
+    p = mmap(NULL,len,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB,-1,0);
+    if (p != MAP_FAILED) {
+        h = (large_hdr_t*) p;
+        h->hugetlb = 1;
+    }
+#endif
+    if (p == MAP_FAILED) {
+        /* map one huge page more and cut it down to an aligned range */
+        p = mmap(NULL,len + HUGE_PAGE,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+        if (p == MAP_FAILED) {
+            fprintf(stderr, "ERROR: safe_malloc_large(%zu) cannot allocate memory.", size);
+            exit(EXIT_FAILURE);
+        }
+        skip = (HUGE_PAGE - ((size_t) p & (HUGE_PAGE - 1))) & (HUGE_PAGE - 1);
+        if (skip) munmap(p,skip);
+        munmap(p + skip + len,HUGE_PAGE - skip);
+        p += skip;
+#ifdef MADV_HUGEPAGE
+        madvise(p,len,MADV_HUGEPAGE);
+#endif
+        h = (large_hdr_t*) p;
+        h->hugetlb = 0;
+    }
+    h->map = p;
+    h->len = len;
+    h->size = size;
+    h->counted = 0;
+    node = large_bind(p,len);
+
+    pthread_mutex_lock(&large_lock);
+    large_total.bytes += len;
+    if (node >= 0 && node < 64) large_total.bound |= (uint64_t) 1 << node;
+    pthread_mutex_unlock(&large_lock);
+
+    return p + LARGE_HDR;
+}
+
+/*
+ * shrink a buffer of safe_malloc_large() to size bytes, the contents
+ * stay where they are. the pages at the end are unmapped
+ */
+void*
+safe_shrink_large(void* ptr,size_t size)
+{
+    large_hdr_t* h = (large_hdr_t*)((uint8_t*) ptr - LARGE_HDR);
+    size_t len,page;
+
+    if (h->map == NULL) {
+        h = (large_hdr_t*) safe_realloc(h,size + LARGE_HDR);
+        return (uint8_t*) h + LARGE_HDR;
+    }
+    large_count(h);
+    page = h->hugetlb ? HUGE_PAGE : (size_t) sysconf(_SC_PAGESIZE);
+    len = (size + LARGE_HDR + page - 1) & ~(page - 1);
+    if (len < h->len) {
+        munmap(h->map + len,h->len - len);
+        h->len = len;
+    }
+    h->size = size;
+    return ptr;
+}
+
+void
+free_large(void* ptr)
+{
+    large_hdr_t* h;
+
+    if (ptr == NULL) return;
+    h = (large_hdr_t*)((uint8_t*) ptr - LARGE_HDR);
+    if (h->map == NULL) {
+        free(h);
+        return;
+    }
+    large_count(h);
+    munmap(h->map,h->len);
+}
+
+/* collect where the pages of the large buffers are, from now on */
+void
+large_track_pages(int on)
+{
+    large_track = on;
+}
+
+void
+large_get_stats(large_stats_t* stats)
+{
+    pthread_mutex_lock(&large_lock);
+    *stats = large_total;
+    pthread_mutex_unlock(&large_lock);
+}
+
+void
+fatal(const char* format, ...)
+{
+    va_list vargs;
+
+    va_start(vargs, format);
+    vfprintf(stderr, format, vargs);
+    fprintf(stderr, "\n");
+    exit(EXIT_FAILURE);
+}
+
+uint64_t
+gettime()
+{
+    struct timeval tp;
+
+    gettimeofday(&tp,NULL);
+
+    return (tp.tv_sec*1000000) + tp.tv_usec;
+}
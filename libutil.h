@@ -1,62 +1,85 @@
-/*
- * File:   libutil.h
- * Author: Matthias Petri
- *
- * misc stuff
- */
-
-#ifndef LIBUTIL_H
-#define	LIBUTIL_H
-
-#ifdef	__cplusplus
-extern "C" {
-#endif
-
-#include <stdio.h>
-#include <stdlib.h>
-#include <stdint.h>
-#include <string.h>
-#include <stdarg.h>
-#include <unistd.h>
-#include <sys/time.h>
-
-#include "bitfile.h"
-
-#define ALPHABET_SIZE     256
-#define REALLOC_INCREMENT 256
-#define GETOPT_FINISHED -1
-
-#ifndef TRUE
-#define TRUE 1
-#endif
-#ifndef FALSE
-#define FALSE 0
-#endif
-
-#ifndef MIN
-#define MIN(a,b) ((a) < (b) ? (a) : (b))
-#endif
-#ifndef MAX
-#define MAX(a,b) ((a) > (b) ? (a) : (b))
-#endif
-#ifndef ABS
-#define ABS(x) (((x) < 0) ? -(x) : + (x) )
-#endif
-
-    void* safe_malloc(size_t size);
-    void* safe_realloc(void* old_mem, size_t new_size);
-    char* safe_strdup(const char* str);
-    char* safe_strcat(char* str1, const char* str2);
-    void fatal(const char* format, ...);
-    FILE* safe_fopen(const char* filename,const char* mode);
-    int safe_filesize(FILE* f);
-    void safe_fclose(FILE* f);
-
-    uint64_t gettime();
-
-#ifdef	__cplusplus
-}
-#endif
-
-#endif	/* LIBUTIL_H */
-
+/*
+ * File:   libutil.h
+ * Author: Matthias Petri
+ *
+ * misc stuff
+ */
+
+#ifndef LIBUTIL_H
+#define	LIBUTIL_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <sys/time.h>
+
+#include "bitfile.h"
+
+#define ALPHABET_SIZE     256
+#define REALLOC_INCREMENT 256
+#define GETOPT_FINISHED -1
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#ifndef MIN
+#define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a,b) ((a) > (b) ? (a) : (b))
+#endif
+#ifndef ABS
+#define ABS(x) (((x) < 0) ? -(x) : + (x) )
+#endif
+
+/* buffers of at least this size are mapped on huge pages */
+#define LARGE_ALLOC_MIN (8*1024*1024)
+
+    /* what safe_malloc_large() mapped so far. huge_bytes and nodes
+       are only collected after large_track_pages(1) */
+    typedef struct {
+        uint64_t bytes;         /* mapped */
+        uint64_t huge_bytes;    /* of those, on 2 MiB pages when filled */
+        uint64_t bound;         /* bit i: some bound to numa node i */
+        uint64_t nodes;         /* bit i: some had pages on numa node i */
+    } large_stats_t;
+
+    void* safe_malloc(size_t size);
+    void* safe_realloc(void* old_mem, size_t new_size);
+    char* safe_strdup(const char* str);
+    char* safe_strcat(char* str1, const char* str2);
+    void fatal(const char* format, ...);
+    FILE* safe_fopen(const char* filename,const char* mode);
+    int64_t safe_filesize(FILE* f);
+    void safe_fclose(FILE* f);
+    void write_uint32(FILE* f,uint32_t v);
+    uint32_t read_uint32(FILE* f);
+    void write_uint64(FILE* f,uint64_t v);
+    uint64_t read_uint64(FILE* f);
+    uint8_t* safe_mmap(FILE* f,size_t len,int writable);
+    void safe_munmap(uint8_t* p,size_t len);
+    void* safe_malloc_large(size_t size);
+    void* safe_shrink_large(void* ptr,size_t size);
+    void free_large(void* ptr);
+    void large_track_pages(int on);
+    void large_get_stats(large_stats_t* stats);
+
+    uint64_t gettime();
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBUTIL_H */
+
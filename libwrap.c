@@ -0,0 +1,99 @@
+/*
+ * File:   libwrap.c
+ * Author: Matthias Petri
+ *
+ * removes the newline after every line of a fixed width, as in the
+ * sequence of a fasta file wrapped at 60 or 80 bases. a newline every
+ * line cuts the 32 base words of dna_ssort(), and without them the
+ * sequence is a dna_block(). shorter lines keep their newline, lines
+ * longer than the width are exceptions: their positions are kept, so
+ * the decoder does not put a newline in them.
+ */
+
+#include "libwrap.h"
+
+/*
+ * the most frequent line width of in[0..n-1] if its lines are worth
+ * unwrapping, else 0. *nexc is the number of exceptions it makes
+ */
+int32_t
+wrap_width(const uint8_t* in,int64_t n,int64_t* nexc)
+{
+    int64_t cnt[WRAP_MAX_WIDTH+2];
+    int64_t i,start,longer;
+    int32_t w,width;
+
+    memset(cnt,0,sizeof(cnt));
+    for (i=0,start=0; i<n; i++) {
+        if (in[i] != '\n') continue;
+        cnt[MIN(i-start,WRAP_MAX_WIDTH+1)]++;
+        start = i+1;
+    }
+    width = WRAP_MIN_WIDTH;
+    for (w=WRAP_MIN_WIDTH; w<=WRAP_MAX_WIDTH; w++)
+        if (cnt[w] > cnt[width]) width = w;
+    if (cnt[width] == 0 || cnt[width]*(width+1) < n/WRAP_MIN_COVER) return 0;
+
+    /* the last line has no newline */
+    longer = (n-start >= width);
+    for (w=width+1; w<=WRAP_MAX_WIDTH+1; w++) longer += cnt[w];
+    if (longer > cnt[width]/WRAP_MAX_EXC) return 0;
+    *nexc = longer;
+    return width;
+}
+
+/*
+ * copy in[0..n-1] to out without the newlines after lines of width
+ * bytes. the positions in out at which longer lines reach the width
+ * go to exc, wrap_width() tells how many. returns the size of out
+ */
+int64_t
+wrap_encode(const uint8_t* in,int64_t n,uint8_t* out,int32_t width,int64_t* exc)
+{
+    int64_t i,col = 0,m = 0;
+
+    for (i=0; i<n; i++) {
+        out[m++] = in[i];
+        if (in[i] == '\n') {
+            col = 0;
+            continue;
+        }
+        if (++col == width) {
+            if (i+1 < n && in[i+1] == '\n') {
+                i++;
+                col = 0;
+            } else *exc++ = m;
+        }
+    }
+    return m;
+}
+
+/*
+ * decode the m bytes of in into the n bytes of out, putting a newline
+ * after every width bytes of a line but at the nexc positions of exc
+ */
+void
+wrap_decode(const uint8_t* in,int64_t m,uint8_t* out,int64_t n,int32_t width,
+            const int64_t* exc,int64_t nexc)
+{
+    int64_t i,j = 0,x = 0,col = 0;
+
+    for (i=0; i<m; i++) {
+        if (j == n) fatal("block corrupt (line wrap).");
+        out[j++] = in[i];
+        if (in[i] == '\n') {
+            col = 0;
+            continue;
+        }
+        if (++col == width) {
+            if (x < nexc && exc[x] == i+1) {
+                x++;
+                continue;
+            }
+            if (j == n) fatal("block corrupt (line wrap).");
+            out[j++] = '\n';
+            col = 0;
+        }
+    }
+    if (j != n || x != nexc) fatal("block corrupt (line wrap).");
+}
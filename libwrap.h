@@ -0,0 +1,36 @@
+/*
+ * File:   libwrap.h
+ * Author: Matthias Petri
+ *
+ * pre-pass removing the newlines of fixed width lines in front of the bwt
+ */
+
+#ifndef LIBWRAP_H
+#define	LIBWRAP_H
+
+#ifdef	__cplusplus
+extern "C" {
+#endif
+
+#include "libutil.h"
+
+/* widths of the lines looked for */
+#define WRAP_MIN_WIDTH 16
+#define WRAP_MAX_WIDTH 1024
+/* blocks are only unwrapped if lines of the width cover at least
+   1/WRAP_MIN_COVER of them, and there are at most 1/WRAP_MAX_EXC as
+   many longer lines as lines of the width */
+#define WRAP_MIN_COVER 2
+#define WRAP_MAX_EXC 64
+
+    int32_t wrap_width(const uint8_t* in,int64_t n,int64_t* nexc);
+    int64_t wrap_encode(const uint8_t* in,int64_t n,uint8_t* out,int32_t width,
+                        int64_t* exc);
+    void wrap_decode(const uint8_t* in,int64_t m,uint8_t* out,int64_t n,int32_t width,
+                     const int64_t* exc,int64_t nexc);
+
+#ifdef	__cplusplus
+}
+#endif
+
+#endif	/* LIBWRAP_H */
@@ -1,174 +1,821 @@
-/*
- * File:   main.c
- * Author: Matthias Petri
- *
- * main aazip
- */
-
-#include "libutil.h"
-#include "libbwt.h"
-#include "libhuff.h"
-#include "liblupdate.h"
-
-enum mode_t {
-    UNKNOWN,
-    SIMPLE,
-    MTF,
-    FC,
-    WFC,
-    TS
-};
-
-static void
-print_usage(const char* program)
-{
-    fprintf(stderr, "USAGE: %s -m [algorithm] <input>\n", program);
-    fprintf(stderr, "  -m algorithm [simple, mtf, fc, wfc, timestamp]\n");
-    fprintf(stderr, "  -h Display usage information\n");
-    fprintf(stderr, "\n");
-    fprintf(stderr, "EXAMPLE: %s -m mtf test.dat\n",
-            program);
-    fprintf(stderr, "\n");
-    return;
-}
-
-/*
- * aazip - compress files using a transform based compression system
- */
-int main(int argc, char** argv)
-{
-    FILE* f;
-    bit_file_t* of;
-    char* infile,*outfile;
-    uint8_t* input,*lupdate,*bwt,lumode;
-    int32_t I,osize,opt;
-    uint32_t size;
-    mode_t lupdate_alg;
-    float ient,oent;
-    uint64_t cost,tstart,tstop,elapsed;
-
-    /* parse command line parameter */
-    opt = GETOPT_FINISHED;
-    if (argc <= 1) {
-        print_usage(argv[0]);
-        exit(EXIT_FAILURE);
-    }
-    while ((opt = getopt(argc, argv, "m:h")) != GETOPT_FINISHED) {
-        switch (opt) {
-            case 'm':
-                if (strcmp(optarg, "simple") == 0) lupdate_alg = SIMPLE;
-                else if (strcmp(optarg, "mtf") == 0) lupdate_alg = MTF;
-                else if (strcmp(optarg, "fc") == 0) lupdate_alg = FC;
-                else if (strcmp(optarg, "wfc") == 0) lupdate_alg = WFC;
-                else if (strcmp(optarg, "timestamp") == 0) lupdate_alg = TS;
-                else fatal("ERROR: mode <%s> unknown!\n", optarg);
-                break;
-            case 'h':
-            default:
-                print_usage(argv[0]);
-                exit(EXIT_FAILURE);
-        }
-    }
-    /* read input file name */
-    if (optind < argc) infile = argv[optind];
-    else {
-        print_usage(argv[0]);
-        exit(EXIT_FAILURE);
-    }
-
-    /* read input file */
-    f = safe_fopen(infile,"r");
-    size = safe_filesize(f);
-    input = (uint8_t*) safe_malloc(size+1);
-    if (fread(input,1,size,f)!=(size_t)size) {
-        fatal("read input file.");
-    }
-    safe_fclose(f);
-    input[size] = 0;
-
-    /* TODO calculate input entropy */
-    ient = 0.0f;
-
-    /* perform bwt */
-    bwt = (uint8_t*) safe_malloc(size);
-
-    tstart = gettime();
-
-    bwt = transform_bwt(input,size,bwt,&I);
-
-    /* peform list update */
-    switch (lupdate_alg) {
-        case SIMPLE:
-            fprintf(stdout,"ALGORITHM: simple\n");
-            lupdate = lupdate_simple(bwt,size,input,&cost);
-            break;
-        case MTF:
-            fprintf(stdout,"ALGORITHM: move to front\n");
-            lupdate = lupdate_movetofront(bwt,size,input,&cost);
-            break;
-        case FC:
-            fprintf(stdout,"ALGORITHM: frequency count\n");
-            lupdate = lupdate_freqcount(bwt,size,input,&cost);
-            break;
-        case WFC:
-            fprintf(stdout,"ALGORITHM: weighted frequency count\n");
-            lupdate = lupdate_wfc(bwt,size,input,&cost);
-            break;
-        case TS:
-            fprintf(stdout,"ALGORITHM: timestamp\n");
-            lupdate = lupdate_timestamp(bwt,size,input,&cost);
-            break;
-        default:
-            fatal("unkown list update algorithm.");
-    }
-
-    fprintf(stdout,"INPUT: %s (%d bytes)\n",infile,size);
-    fprintf(stdout,"COST: %lu\n",cost);
-
-    /* TODO calculate entropy after list update*/
-    oent = 0.0f;
-
-    /* write output */
-    outfile = safe_strcat(infile,".aazip");
-    /* create bit file for writing */
-    of = BitFileOpen(outfile, BF_WRITE);
-
-    /* write aa zip header */
-    BitFilePutChar('A', of);
-    BitFilePutChar('A', of);
-
-    /* write I */
-    BitFilePutBitsInt(of,&I,32,sizeof(uint32_t));
-
-    /* write lupdate mode */
-    lumode = lupdate_alg;
-    BitFilePutBitsInt(of,&lumode,8,sizeof(uint8_t));
-
-
-    fprintf(stderr,"I %d lumode %d\n",I,lumode);
-
-    /* perform huffman coding */
-    encode_huffman(lupdate,size,of);
-
-    tstop = gettime();
-
-    elapsed = tstop - tstart;
-    fprintf(stdout,"TIME: %.3f s\n",(float)elapsed/1000000);
-
-    /* flush and get file stats */
-    BitFileFlushOutput(of,0);
-    f = BitFileToFILE(of);
-    osize = ftell(f);
-
-    fprintf(stdout,"OUTPUT: %s\n",outfile);
-    fprintf(stdout,"ENTROPY: %.2f bps / %.2f bps\n",ient,oent);
-    fprintf(stdout,"COMPRESSION: %.2f\n",((float)osize/(float)size)*100);
-
-    /* clean up*/
-    safe_fclose(f);
-    free(input);
-    free(bwt);
-
-    return (EXIT_SUCCESS);
-}
-
+/*
+ * File:   main.c
+ * Author: Matthias Petri
+ *
+ * main aazip
+ */
+
+#include "libutil.h"
+#include "libbwt.h"
+#include "libebwt.h"
+#include "libhuff.h"
+#include "liblupdate.h"
+#include "libpool.h"
+#include "librle.h"
+#include "liblzp.h"
+#include "libwrap.h"
+#include "libdna.h"
+#include "libst.h"
+
+#include <errno.h>
+#include <limits.h>
+
+#define MIN_BLOCK_SIZE 1024
+#define MAX_THREADS 1024
+/* set in the primary index count of run length coded blocks, which
+   also store their original size, of lzp coded blocks and of unwrapped
+   dna blocks */
+#define BLOCK_RLE1 0x80
+#define BLOCK_LZP 0x40
+#define BLOCK_WRAP 0x20
+
+enum mode_t {
+    UNKNOWN,
+    SIMPLE,
+    MTF,
+    FC,
+    WFC,
+    TS
+};
+
+/* shared by all blocks of one run */
+typedef struct {
+    ds_ctx_t** ctx;     /* one sorting context per worker */
+    mode_t lupdate_alg;
+    bwt_sorter_t sorter;
+    uint64_t nsorted[BWT_SORT_AUTO];    /* blocks sorted by each sorter */
+    uint64_t nrle;      /* blocks run length coded before the bwt */
+    uint64_t nlzp;      /* blocks lzp coded before the bwt */
+    uint64_t nwrap;     /* blocks with their line wrapping removed */
+    int32_t lzp_min_len;    /* 0 without lzp */
+    int32_t st_order;   /* st-k instead of the bwt if not 0 */
+    uint64_t block_size;
+    int32_t padding;    /* bytes after each block the bwt may use */
+    uint64_t ext_mem;   /* -e, 0 without. bounds the inverse bwt as well */
+    pool_t* pool;
+    pool_t* sort_pool;  /* sorts within the block if there is only one */
+    int32_t nthreads;
+} job_t;
+
+/* one independently (de)compressed block */
+typedef struct {
+    pool_task_t task;
+    job_t* job;
+    uint8_t* data;
+    uint64_t size;
+    uint64_t cost;
+    bwt_sorter_t sorter;
+    int rle;
+    int lzp;
+    int wrap;
+    char* out;
+    size_t out_len;
+} block_t;
+
+/* reads the next block into b->data/b->size, returns 0 at end of input */
+typedef int (*read_block_fn)(FILE* f,block_t* b);
+
+static void
+print_usage(const char* program)
+{
+    fprintf(stderr, "USAGE: %s -m [algorithm] <input>\n", program);
+    fprintf(stderr, "       %s -d <input.aazip>\n", program);
+    fprintf(stderr, "  -m algorithm [simple, mtf, fc, wfc, timestamp]\n");
+    fprintf(stderr, "  -d decompress\n");
+    fprintf(stderr, "  -s suffix sorter [ds, sais, dna, auto] [auto]\n");
+    fprintf(stderr, "  -p deep-shallow parameters, comma separated, e.g. adist=250,shallow=300\n");
+    fprintf(stderr, "     adist, shallow, blind, mkqs, b2g, word or auto to tune per block\n");
+    fprintf(stderr, "  -k sort contexts to this depth (%d to %d) instead of a full bwt [off]\n",
+            ST_MIN_ORDER, ST_MAX_ORDER);
+    fprintf(stderr, "  -l lzp code repeats of at least this length before the bwt [off]\n");
+    fprintf(stderr, "  -b block size (e.g. 900k, 64M, 4G) [whole file]\n");
+    fprintf(stderr, "  -t number of threads [number of cpus]\n");
+    fprintf(stderr, "  -e memory budget of the external memory bwt (e.g. 8G),\n");
+    fprintf(stderr, "     the whole file is one block. decoding it takes 6 to 10\n");
+    fprintf(stderr, "     times the file, with -d -e about 3 times but slower\n");
+    fprintf(stderr, "  -v show where the pages of the sort buffers were, reads /proc\n");
+    fprintf(stderr, "  -h Display usage information\n");
+    fprintf(stderr, "\n");
+    fprintf(stderr, "EXAMPLE: %s -m mtf test.dat\n",
+            program);
+    fprintf(stderr, "\n");
+    return;
+}
+
+/*
+ * parse a size such as 900k or 64M
+ */
+static uint64_t
+parse_size(const char* str)
+{
+    char* end;
+    double size;
+
+    size = strtod(str,&end);
+    if (*end == 'k' || *end == 'K') size *= 1024;
+    else if (*end == 'm' || *end == 'M') size *= 1024*1024;
+    else if (*end == 'g' || *end == 'G') size *= 1024.0*1024*1024;
+    else if (*end == 't' || *end == 'T') size *= 1024.0*1024*1024*1024;
+    else if (*end != 0) fatal("ERROR: block size <%s> invalid!\n", str);
+
+    if (size < MIN_BLOCK_SIZE || size >= (double) INT64_MAX)
+        fatal("ERROR: block size <%s> out of range!\n", str);
+
+    return (uint64_t) size;
+}
+
+/*
+ * parse an integer in [lo,hi], anything else prints the usage
+ */
+static int
+parse_int(const char* program,const char* what,const char* str,long lo,long hi)
+{
+    char* end;
+    long v;
+
+    errno = 0;
+    v = strtol(str,&end,10);
+    if (end == str || *end != 0 || errno == ERANGE || v < lo || v > hi) {
+        fprintf(stderr, "ERROR: %s <%s> must be a number from %ld to %ld!\n",
+                what, str, lo, hi);
+        print_usage(program);
+        exit(EXIT_FAILURE);
+    }
+    return (int) v;
+}
+
+/*
+ * parse deep-shallow parameters such as adist=250,shallow=300,auto
+ */
+static void
+parse_ds_params(const char* program,const char* str,ds_params_t* p)
+{
+    char* copy,*tok,*val;
+
+    copy = safe_strdup(str);
+    for (tok = strtok(copy,","); tok != NULL; tok = strtok(NULL,",")) {
+        if (strcmp(tok,"auto") == 0) {
+            p->autotune = 1;
+            continue;
+        }
+        if ((val = strchr(tok,'=')) == NULL)
+            fatal("ERROR: parameter <%s> needs a value!\n", tok);
+        *val++ = 0;
+        if (strcmp(tok,"adist") == 0) {
+            p->anchor_dist = parse_int(program,tok,val,0,65535);
+            p->set |= DS_SET_ADIST;
+        } else if (strcmp(tok,"shallow") == 0) {
+            p->shallow_limit = parse_int(program,tok,val,0,DS_PARAM_MAX);
+            p->set |= DS_SET_SHALLOW;
+        } else if (strcmp(tok,"blind") == 0) {
+            p->blind_sort_ratio = parse_int(program,tok,val,1,DS_PARAM_MAX);
+            p->set |= DS_SET_BLIND;
+        } else if (strcmp(tok,"mkqs") == 0)
+            p->mk_qs_thresh = parse_int(program,tok,val,0,Max_thresh);
+        else if (strcmp(tok,"b2g") == 0)
+            p->b2g_ratio = parse_int(program,tok,val,1,DS_PARAM_MAX);
+        else if (strcmp(tok,"word") == 0)
+            p->word_size = parse_int(program,tok,val,1,8);
+        else fatal("ERROR: parameter <%s> unknown!\n", tok);
+    }
+    free(copy);
+}
+
+static uint8_t*
+perform_lupdate(mode_t alg,uint8_t* bwt,uint64_t size,uint8_t* output,uint64_t* cost)
+{
+    switch (alg) {
+        case SIMPLE:
+            return lupdate_simple(bwt,size,output,cost);
+        case MTF:
+            return lupdate_movetofront(bwt,size,output,cost);
+        case FC:
+            return lupdate_freqcount(bwt,size,output,cost);
+        case WFC:
+            return lupdate_wfc(bwt,size,output,cost);
+        case TS:
+            return lupdate_timestamp(bwt,size,output,cost);
+        default:
+            fatal("unkown list update algorithm.");
+    }
+    return NULL;
+}
+
+static uint8_t*
+perform_lupdate_inverse(mode_t alg,uint8_t* input,uint64_t size,uint8_t* bwt)
+{
+    switch (alg) {
+        case SIMPLE:
+            return lupdate_simple_inverse(input,size,bwt);
+        case MTF:
+            return lupdate_movetofront_inverse(input,size,bwt);
+        case FC:
+            return lupdate_freqcount_inverse(input,size,bwt);
+        case WFC:
+            return lupdate_wfc_inverse(input,size,bwt);
+        case TS:
+            return lupdate_timestamp_inverse(input,size,bwt);
+        default:
+            fatal("unkown list update algorithm.");
+    }
+    return NULL;
+}
+
+/*
+ * bwt, list update and huffman code one block into an in memory
+ * stream. line wrapped dna loses its newlines first, so it can be
+ * sorted by dna_ssort(). then blocks with long runs are run length
+ * coded, and with -l long repeats are lzp coded. runs on a pool
+ * worker.
+ */
+static void
+compress_block(void* arg,int worker)
+{
+    block_t* b = (block_t*) arg;
+    uint8_t* bwt,*pre,esc;
+    int64_t idx[BWT_MAX_INDEX];
+    int64_t m,nexc = 0,*exc = NULL;
+    int32_t i,k,flags,width;
+    uint64_t n,rle_size,lzp_size;
+    FILE* mf;
+    bit_file_t* bf;
+
+    n = b->size;
+    /* only blocks that look like dna are scanned for their lines */
+    width = dna_probe(b->data,n) ? wrap_width(b->data,n,&nexc) : 0;
+    if (width) {
+        pre = (uint8_t*) safe_malloc(n + b->job->padding);
+        exc = (int64_t*) safe_malloc(MAX(nexc,1)*sizeof(int64_t));
+        m = wrap_encode(b->data,n,pre,width,exc);
+        b->wrap = dna_block(pre,m);
+        if (b->wrap) {
+            free(b->data);
+            b->data = pre;
+            n = m;
+        } else free(pre);
+    }
+
+    rle_size = n;
+    m = rle1_size(b->data,n);
+    b->rle = (uint64_t) m <= n - n/RLE1_MIN_GAIN;
+    if (b->rle) {
+        pre = (uint8_t*) safe_malloc(m + b->job->padding);
+        rle1_encode(b->data,n,pre);
+        free(b->data);
+        b->data = pre;
+        n = m;
+    }
+
+    lzp_size = n;
+    if (b->job->lzp_min_len) {
+        pre = (uint8_t*) safe_malloc(n + b->job->padding);
+        m = lzp_encode(b->data,n,pre,b->job->lzp_min_len,&esc);
+        b->lzp = m >= 0;
+        if (b->lzp) {
+            free(b->data);
+            b->data = pre;
+            n = m;
+        } else free(pre);
+    }
+
+    /* perform bwt, built in place of the suffix array */
+    if (b->job->st_order) {
+        k = 1;
+        bwt = transform_st(b->data,n,NULL,idx,b->job->st_order);
+    } else {
+        k = bwt_num_index(n);
+        b->sorter = bwt_fit_sorter(b->data,n,b->job->sorter);
+        bwt = transform_bwt_sampled(b->job->ctx[worker],&b->sorter,
+                                    b->data,n,NULL,idx,k,b->job->padding);
+    }
+
+    /* peform list update, the input buffer is no longer needed */
+    perform_lupdate(b->job->lupdate_alg,bwt,n,b->data,&b->cost);
+    free_large(bwt);
+
+    /* write the primary indices, the original size, line width and
+       exceptions of unwrapped blocks, the size before run length
+       coding, the size, escape and match length of lzp coded blocks
+       and the huffman coded block */
+    mf = open_memstream(&b->out,&b->out_len);
+    if (mf == NULL) fatal("open_memstream failed.");
+    bf = MakeBitFile(mf,BF_WRITE);
+    flags = k | (b->rle ? BLOCK_RLE1 : 0) | (b->lzp ? BLOCK_LZP : 0) |
+            (b->wrap ? BLOCK_WRAP : 0);
+    BitFilePutBitsInt(bf,&flags,8,sizeof(int32_t));
+    for (i=0; i<k; i++) BitFilePutBitsInt(bf,&idx[i],64,sizeof(int64_t));
+    if (b->wrap) {
+        BitFilePutBitsInt(bf,&b->size,64,sizeof(uint64_t));
+        BitFilePutBitsInt(bf,&width,32,sizeof(int32_t));
+        BitFilePutBitsInt(bf,&nexc,64,sizeof(int64_t));
+        for (i=0; i<nexc; i++) BitFilePutBitsInt(bf,&exc[i],64,sizeof(int64_t));
+    }
+    free(exc);
+    if (b->rle) BitFilePutBitsInt(bf,&rle_size,64,sizeof(uint64_t));
+    if (b->lzp) {
+        BitFilePutBitsInt(bf,&lzp_size,64,sizeof(uint64_t));
+        BitFilePutBitsInt(bf,&esc,8,sizeof(uint8_t));
+        BitFilePutBitsInt(bf,&b->job->lzp_min_len,32,sizeof(int32_t));
+    }
+    encode_huffman(b->data,n,bf);
+    BitFileClose(bf);
+
+    free(b->data);
+    b->data = NULL;
+}
+
+/* the next bytes bytes of *p, least significant first as written by
+   BitFilePutBitsInt */
+static uint64_t
+get_le(uint8_t** p,int32_t bytes)
+{
+    uint64_t v = 0;
+    int32_t i;
+
+    for (i=0; i<bytes; i++) v |= (uint64_t)(*p)[i] << (8*i);
+    *p += bytes;
+    return v;
+}
+
+/*
+ * huffman decode, invert the list update and the bwt of one block,
+ * then the lzp and run length coding and the line unwrapping. runs on
+ * a pool worker.
+ */
+static void
+decompress_block(void* arg,int worker)
+{
+    block_t* b = (block_t*) arg;
+    uint8_t* lupdate,*bwt,*p,esc;
+    int64_t idx[BWT_MAX_INDEX];
+    int64_t nexc = 0,*exc = NULL;
+    int32_t i,k,min_len,width = 0;
+    uint64_t n,size,lzp_size,wrap_size = 0;
+
+    (void) worker;
+
+    if (b->size < 1) fatal("block truncated.");
+    b->rle = (b->data[0] & BLOCK_RLE1) != 0;
+    b->lzp = (b->data[0] & BLOCK_LZP) != 0;
+    b->wrap = (b->data[0] & BLOCK_WRAP) != 0;
+    k = b->data[0] & ~(BLOCK_RLE1|BLOCK_LZP|BLOCK_WRAP);
+    if (k < 1 || k > BWT_MAX_INDEX) fatal("block corrupt (%d primary indices).",k);
+    if (b->size < 1 + 8*(uint64_t)(k+b->rle) + 13*b->lzp + 20*b->wrap) fatal("block truncated.");
+    p = b->data + 1;
+    for (i=0; i<k; i++) idx[i] = (int64_t) get_le(&p,8);
+    if (b->wrap) {
+        wrap_size = get_le(&p,8);
+        width = (int32_t) get_le(&p,4);
+        nexc = (int64_t) get_le(&p,8);
+        if (width < 1 || nexc < 0 || (uint64_t) nexc > (b->size - (p-b->data))/8)
+            fatal("block corrupt (line wrap).");
+        exc = (int64_t*) safe_malloc(MAX(nexc,1)*sizeof(int64_t));
+        for (i=0; i<nexc; i++) exc[i] = (int64_t) get_le(&p,8);
+        if (b->size - (p-b->data) < 8*(uint64_t)b->rle + 13*b->lzp) fatal("block truncated.");
+    }
+    size = b->rle ? get_le(&p,8) : 0;
+    lzp_size = min_len = esc = 0;
+    if (b->lzp) {
+        lzp_size = get_le(&p,8);
+        esc = (uint8_t) get_le(&p,1);
+        min_len = (int32_t) get_le(&p,4);
+    }
+    lupdate = decode_huffman(p,b->size-(p-b->data),&n);
+    free(b->data);
+    b->data = NULL;
+
+    bwt = (uint8_t*) safe_malloc(MAX(n,1));
+    perform_lupdate_inverse(b->job->lupdate_alg,lupdate,n,bwt);
+    if (b->job->st_order) {
+        if (k != 1) fatal("block corrupt (%d primary indices).",k);
+        reverse_st(bwt,n,idx[0],b->job->st_order,lupdate);
+    } else if (b->job->ext_mem && reverse_bwt_space(n) > b->job->ext_mem) {
+        /* an -e archive is one block, its psi array takes 4 to 8 times
+           the file */
+        if (reverse_bwt_lowmem_space(n) > b->job->ext_mem)
+            fatal("ERROR: the bwt of a %lu byte block needs %lu bytes to decode, more than -e.",
+                  n,reverse_bwt_lowmem_space(n));
+        reverse_bwt_lowmem(bwt,n,idx,k,lupdate);
+    } else reverse_bwt_sampled(bwt,n,idx,k,lupdate);
+    free(bwt);
+
+    if (b->lzp) {
+        bwt = (uint8_t*) safe_malloc(MAX(lzp_size,1));
+        lzp_decode(lupdate,n,bwt,lzp_size,min_len,esc);
+        free(lupdate);
+        lupdate = bwt;
+        n = lzp_size;
+    }
+    if (b->rle) {
+        bwt = (uint8_t*) safe_malloc(MAX(size,1));
+        rle1_decode(lupdate,n,bwt,size);
+        free(lupdate);
+        lupdate = bwt;
+        n = size;
+    }
+    if (b->wrap) {
+        bwt = (uint8_t*) safe_malloc(MAX(wrap_size,1));
+        wrap_decode(lupdate,n,bwt,wrap_size,width,exc,nexc);
+        free(lupdate);
+        free(exc);
+        lupdate = bwt;
+        n = wrap_size;
+    }
+
+    b->out = (char*) lupdate;
+    b->out_len = n;
+}
+
+static int
+read_raw_block(FILE* f,block_t* b)
+{
+    /* padded so the bwt can sort the block in place */
+    b->data = (uint8_t*) safe_malloc(b->job->block_size + b->job->padding);
+    b->size = fread(b->data,1,b->job->block_size,f);
+    if (b->size < b->job->block_size && ferror(f)) fatal("read input file.");
+    if (b->size == 0) {
+        free(b->data);
+        return 0;
+    }
+    return 1;
+}
+
+static int
+read_compressed_block(FILE* f,block_t* b)
+{
+    int c;
+
+    if ((c = fgetc(f)) == EOF) return 0;
+    ungetc(c,f);
+
+    b->size = read_uint64(f);
+    b->data = (uint8_t*) safe_malloc(MAX(b->size,1));
+    if (fread(b->data,1,b->size,f) != b->size) fatal("ERROR: unexpected end of file.");
+    return 1;
+}
+
+/*
+ * run fn on every block of the input on the pool, keeping at most two
+ * blocks per thread in flight, and write the results in input order.
+ * with write_len every output block is prefixed by its length.
+ * returns the number of blocks, their total input size and cost.
+ */
+static uint64_t
+process_blocks(job_t* job,FILE* f,FILE* of,read_block_fn read_block,
+               void (*fn)(void*,int),int write_len,uint64_t* size,uint64_t* cost)
+{
+    int32_t nslots;
+    uint64_t nread,nwritten;
+    block_t* slots,*b;
+
+    nslots = 2*job->nthreads;
+    slots = (block_t*) safe_malloc(nslots*sizeof(block_t));
+
+    *size = *cost = 0;
+    nread = nwritten = 0;
+    while (1) {
+        while (nread - nwritten < (uint64_t) nslots) {
+            b = &slots[nread % nslots];
+            b->job = job;
+            b->sorter = BWT_SORT_AUTO;  /* set by compress_block */
+            b->rle = b->lzp = b->wrap = 0;
+            if (!read_block(f,b)) break;
+            *size += b->size;
+            pool_submit(job->pool,&b->task,fn,b);
+            nread++;
+        }
+        if (nwritten == nread) break;
+
+        b = &slots[nwritten % nslots];
+        pool_task_wait(job->pool,&b->task);
+        if (write_len) write_uint64(of,b->out_len);
+        if (fwrite(b->out,1,b->out_len,of) != b->out_len)
+            fatal("write output file.");
+        free(b->out);
+        *cost += b->cost;
+        if (b->sorter < BWT_SORT_AUTO) job->nsorted[b->sorter]++;
+        job->nrle += b->rle;
+        job->nlzp += b->lzp;
+        job->nwrap += b->wrap;
+        nwritten++;
+    }
+
+    free(slots);
+    return nwritten;
+}
+
+/*
+ * external memory mode: the whole input is one block. the text, the
+ * bwt and the list update output are mapped files, so only the bwt
+ * construction (bounded by mem) needs memory of its own. returns the
+ * number of blocks written.
+ */
+static uint64_t
+compress_external(job_t* job,FILE* f,FILE* of,uint64_t mem,uint64_t* size,uint64_t* cost)
+{
+    uint8_t* text,*bwt,*lu;
+    int64_t idx[BWT_MAX_INDEX];
+    int64_t n;
+    int32_t i,k;
+    off_t start,end;
+    FILE* bf,*lf;
+    bit_file_t* bits;
+
+    n = safe_filesize(f);
+    *size = n;
+    *cost = 0;
+    if (n == 0) return 0;
+
+    k = bwt_num_index(n);
+    bf = tmpfile();
+    lf = tmpfile();
+    if (bf == NULL || lf == NULL) fatal("tmpfile failed.");
+    text = safe_mmap(f,n,0);
+    transform_bwt_external(text,n,bf,idx,k,mem);
+    safe_munmap(text,n);
+
+    bwt = safe_mmap(bf,n,0);
+    lu = safe_mmap(lf,n,1);
+    perform_lupdate(job->lupdate_alg,bwt,n,lu,cost);
+    safe_munmap(bwt,n);
+    safe_fclose(bf);
+
+    /* same layout as process_blocks, the length is patched in once
+       the block is written */
+    start = ftello(of);
+    write_uint64(of,0);
+    bits = MakeBitFile(of,BF_WRITE);
+    BitFilePutBitsInt(bits,&k,8,sizeof(int32_t));
+    for (i=0; i<k; i++) BitFilePutBitsInt(bits,&idx[i],64,sizeof(int64_t));
+    encode_huffman(lu,n,bits);
+    BitFileToFILE(bits);
+    end = ftello(of);
+    fseeko(of,start,SEEK_SET);
+    write_uint64(of,end-start-8);
+    fseeko(of,end,SEEK_SET);
+
+    safe_munmap(lu,n);
+    safe_fclose(lf);
+    return 1;
+}
+
+static void
+print_nodes(uint64_t nodes)
+{
+    int32_t i;
+
+    if (nodes == 0) fprintf(stdout," -");
+    for (i=0; i<64; i++) if (nodes & ((uint64_t) 1 << i)) fprintf(stdout," %d",i);
+}
+
+/*
+ * how much of the large sort buffers were mapped and the numa nodes
+ * they were bound to. with -v also how much was on huge pages and the
+ * nodes the pages were found on
+ */
+static void
+print_page_stats(int verbose)
+{
+    large_stats_t st;
+
+    large_get_stats(&st);
+    fprintf(stdout,"PAGES: %lu MiB mapped, bound to nodes",st.bytes >> 20);
+    print_nodes(st.bound);
+    if (verbose) {
+        fprintf(stdout,", %lu MiB on 2 MiB pages, on nodes",st.huge_bytes >> 20);
+        print_nodes(st.nodes);
+    }
+    fprintf(stdout,"\n");
+}
+
+/*
+ * aazip - compress files using a transform based compression system
+ */
+int main(int argc, char** argv)
+{
+    FILE* f,*of;
+    char* infile,*outfile;
+    uint8_t lumode;
+    int32_t opt,i,nthreads,decompress,single,lzp_min_len,st_order,verbose,ds_given;
+    uint64_t block_size,ext_mem;
+    uint64_t size,osize,nblocks;
+    mode_t lupdate_alg;
+    float ient,oent;
+    uint64_t cost,tstart,tstop,elapsed;
+    bwt_sorter_t sorter;
+    ds_params_t params;
+    job_t job;
+
+    /* parse command line parameter */
+    opt = GETOPT_FINISHED;
+    lupdate_alg = UNKNOWN;
+    block_size = 0;
+    ext_mem = 0;
+    decompress = 0;
+    verbose = 0;
+    lzp_min_len = 0;
+    st_order = 0;
+    sorter = BWT_SORT_AUTO;
+    ds_params_default(&params);
+    ds_given = 0;
+    nthreads = pool_num_cpus();
+    if (argc <= 1) {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+    while ((opt = getopt(argc, argv, "m:b:t:s:e:p:l:k:dvh")) != GETOPT_FINISHED) {
+        switch (opt) {
+            case 'm':
+                if (strcmp(optarg, "simple") == 0) lupdate_alg = SIMPLE;
+                else if (strcmp(optarg, "mtf") == 0) lupdate_alg = MTF;
+                else if (strcmp(optarg, "fc") == 0) lupdate_alg = FC;
+                else if (strcmp(optarg, "wfc") == 0) lupdate_alg = WFC;
+                else if (strcmp(optarg, "timestamp") == 0) lupdate_alg = TS;
+                else fatal("ERROR: mode <%s> unknown!\n", optarg);
+                break;
+            case 'b':
+                block_size = parse_size(optarg);
+                break;
+            case 't':
+                nthreads = parse_int(argv[0],"number of threads",optarg,1,MAX_THREADS);
+                break;
+            case 'd':
+                decompress = 1;
+                break;
+            case 'v':
+                verbose = 1;
+                large_track_pages(1);
+                break;
+            case 'e':
+                ext_mem = parse_size(optarg);
+                break;
+            case 'p':
+                parse_ds_params(argv[0],optarg,&params);
+                ds_given = 1;
+                break;
+            case 'k':
+                st_order = parse_int(argv[0],"st order",optarg,ST_MIN_ORDER,ST_MAX_ORDER);
+                break;
+            case 'l':
+                lzp_min_len = parse_int(argv[0],"lzp match length",optarg,LZP_MIN_LEN,INT32_MAX);
+                break;
+            case 's':
+                if (strcmp(optarg, "ds") == 0) sorter = BWT_SORT_DS;
+                else if (strcmp(optarg, "sais") == 0) sorter = BWT_SORT_SAIS;
+                else if (strcmp(optarg, "dna") == 0) sorter = BWT_SORT_DNA;
+                else if (strcmp(optarg, "auto") == 0) sorter = BWT_SORT_AUTO;
+                else fatal("ERROR: suffix sorter <%s> unknown!\n", optarg);
+                break;
+            case 'h':
+            default:
+                print_usage(argv[0]);
+                exit(EXIT_FAILURE);
+        }
+    }
+    /* read input file name */
+    if (optind < argc) infile = argv[optind];
+    else {
+        print_usage(argv[0]);
+        exit(EXIT_FAILURE);
+    }
+
+    single = 0;
+    if (decompress) {
+        f = safe_fopen(infile,"rb");
+        if (fgetc(f) != 'A' || fgetc(f) != 'A')
+            fatal("ERROR: %s is not an aazip file.", infile);
+        lumode = fgetc(f);
+        lupdate_alg = lumode & 0x0f;
+        st_order = lumode >> 4;
+        block_size = read_uint64(f);
+
+        /* strip .aazip from the output name */
+        i = strlen(infile) - strlen(".aazip");
+        if (i > 0 && strcmp(infile+i,".aazip") == 0) {
+            outfile = safe_strdup(infile);
+            outfile[i] = 0;
+        } else outfile = safe_strcat(infile,".out");
+    } else {
+        /* open input file, without -b the whole file is one block */
+        f = safe_fopen(infile,"r");
+        if (block_size == 0 || ext_mem) block_size = MAX(safe_filesize(f),1);
+        if (st_order && ext_mem) fatal("ERROR: -k needs blocks in memory, not -e!\n");
+        /* checked here once, the blocks take them as they are */
+        if (ds_given && (ext_mem || st_order || sorter == BWT_SORT_SAIS ||
+                         sorter == BWT_SORT_DNA))
+            fatal("ERROR: -p only applies to the ds sorter, not -s sais, -s dna, -e or -k!\n");
+        if (ds_params_check(&params)) {
+            print_usage(argv[0]);
+            exit(EXIT_FAILURE);
+        }
+        if (st_order && block_size > ST_MAX_SIZE)
+            fatal("ERROR: -k needs blocks below 2 GiB, use -b!\n");
+        outfile = safe_strcat(infile,".aazip");
+        /* a single block gets one worker, which sorts on the others */
+        single = block_size >= (uint64_t) safe_filesize(f);
+    }
+
+    switch (lupdate_alg) {
+        case SIMPLE: fprintf(stdout,"ALGORITHM: simple\n"); break;
+        case MTF: fprintf(stdout,"ALGORITHM: move to front\n"); break;
+        case FC: fprintf(stdout,"ALGORITHM: frequency count\n"); break;
+        case WFC: fprintf(stdout,"ALGORITHM: weighted frequency count\n"); break;
+        case TS: fprintf(stdout,"ALGORITHM: timestamp\n"); break;
+        default:
+            fatal("unkown list update algorithm.");
+    }
+
+    /* TODO calculate input entropy */
+    ient = 0.0f;
+
+    of = safe_fopen(outfile,"wb");
+
+    job.lupdate_alg = lupdate_alg;
+    job.sorter = sorter;
+    memset(job.nsorted,0,sizeof(job.nsorted));
+    job.nrle = job.nlzp = job.nwrap = 0;
+    job.lzp_min_len = lzp_min_len;
+    job.st_order = st_order;
+    job.block_size = block_size;
+    job.nthreads = single ? 1 : nthreads;
+    job.ctx = (ds_ctx_t**) safe_malloc(job.nthreads*sizeof(ds_ctx_t*));
+    for (i=0; i<job.nthreads; i++) {
+        job.ctx[i] = ds_ctx_create();
+        ds_ctx_set_params(job.ctx[i],&params);
+    }
+    job.padding = (decompress || st_order) ? 0 : bwt_padding(job.ctx[0]);
+    job.ext_mem = ext_mem;
+    job.pool = pool_create(job.nthreads);
+    job.sort_pool = NULL;
+    if (single && nthreads > 1) {
+        job.sort_pool = pool_create(nthreads);
+        job.ctx[0]->Pool = job.sort_pool;
+    }
+
+    tstart = gettime();
+
+    if (decompress) {
+        nblocks = process_blocks(&job,f,of,read_compressed_block,
+                                 decompress_block,0,&size,&cost);
+        tstop = gettime();
+        osize = ftello(of);
+
+        fprintf(stdout,"INPUT: %s (%lu bytes)\n",infile,(uint64_t) ftello(f));
+        fprintf(stdout,"BLOCKS: %lu (%d threads)\n",nblocks,job.nthreads);
+        fprintf(stdout,"TIME: %.3f s\n",(float)(tstop - tstart)/1000000);
+        print_page_stats(verbose);
+        fprintf(stdout,"OUTPUT: %s (%lu bytes)\n",outfile,osize);
+    } else {
+        /* write aa zip header: magic, lupdate mode with the st order in
+           the high nibble and block size */
+        lumode = lupdate_alg | (st_order << 4);
+        fputc('A',of);
+        fputc('A',of);
+        fputc(lumode,of);
+        write_uint64(of,block_size);
+
+        if (ext_mem) nblocks = compress_external(&job,f,of,ext_mem,&size,&cost);
+        else nblocks = process_blocks(&job,f,of,read_raw_block,
+                                          compress_block,1,&size,&cost);
+        tstop = gettime();
+
+        fprintf(stdout,"INPUT: %s (%lu bytes)\n",infile,size);
+        fprintf(stdout,"BLOCKS: %lu x %lu bytes (%d threads)\n",nblocks,block_size,
+                job.sort_pool ? nthreads : job.nthreads);
+        if (ext_mem) fprintf(stdout,"SORTER: external\n");
+        else if (st_order) fprintf(stdout,"SORTER: st%d\n",st_order);
+        else fprintf(stdout,"SORTER: ds %lu blocks, sais %lu blocks, dna %lu blocks, "
+                         "small %lu blocks\n",
+                         job.nsorted[BWT_SORT_DS],job.nsorted[BWT_SORT_SAIS],
+                         job.nsorted[BWT_SORT_DNA],job.nsorted[BWT_SORT_SMALL]);
+        fprintf(stdout,"WRAP: %lu blocks\n",job.nwrap);
+        fprintf(stdout,"RLE1: %lu blocks\n",job.nrle);
+        if (lzp_min_len) fprintf(stdout,"LZP: %lu blocks\n",job.nlzp);
+        fprintf(stdout,"COST: %lu\n",cost);
+        print_page_stats(verbose);
+
+        /* TODO calculate entropy after list update*/
+        oent = 0.0f;
+
+        elapsed = tstop - tstart;
+        fprintf(stdout,"TIME: %.3f s\n",(float)elapsed/1000000);
+
+        /* get file stats */
+        osize = ftello(of);
+
+        fprintf(stdout,"OUTPUT: %s\n",outfile);
+        fprintf(stdout,"ENTROPY: %.2f bps / %.2f bps\n",ient,oent);
+        fprintf(stdout,"COMPRESSION: %.2f\n",((float)osize/(float)MAX(size,1))*100);
+    }
+
+    /* clean up*/
+    pool_free(job.pool);
+    pool_free(job.sort_pool);
+    for (i=0; i<job.nthreads; i++) ds_ctx_free(job.ctx[i]);
+    free(job.ctx);
+    safe_fclose(f);
+    safe_fclose(of);
+    free(outfile);
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,35 @@
+#!/bin/sh
+# ds on long runs. RLE1 leaves a periodic block behind, which ds_ssort
+# takes seconds per megabyte on, so bwt_fit_sorter has to hand it to
+# sa-is even with -s ds. each case has to round trip within LIMIT
+# seconds, five times what it takes on a slow machine at -O0.
+# usage: tests/runs.sh [aazip]
+
+AAZIP=${1:-./aazip}
+LIMIT=${LIMIT:-2}
+DIR=$(mktemp -d) || exit 1
+trap 'rm -rf "$DIR"' EXIT
+
+# 30 MB of zeros, and 32 MB of 512 byte sectors holding one 0xff
+head -c 30000000 /dev/zero > "$DIR/zeros"
+{ printf '\377'; head -c 511 /dev/zero; } > "$DIR/sectors"
+for i in 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16; do
+    cat "$DIR/sectors" "$DIR/sectors" > "$DIR/x" && mv "$DIR/x" "$DIR/sectors"
+done
+
+fail=0
+for f in zeros sectors; do
+    for s in ds sais auto; do
+        rm -f "$DIR/$f.aazip" "$DIR/x" "$DIR/x.aazip"
+        if ! timeout "$LIMIT" "$AAZIP" -m mtf -s $s "$DIR/$f" > /dev/null; then
+            echo "FAIL: $f -s $s took more than $LIMIT s"; fail=1; continue
+        fi
+        mv "$DIR/$f.aazip" "$DIR/x.aazip"
+        "$AAZIP" -d "$DIR/x.aazip" > /dev/null
+        if ! cmp -s "$DIR/$f" "$DIR/x"; then
+            echo "FAIL: $f -s $s does not round trip"; fail=1; continue
+        fi
+        echo "ok: $f -s $s"
+    done
+done
+exit $fail